@@ -17,6 +17,14 @@
  *    3.1 animal_tree.cpp - implementations for the AnimalTree structure.
  * 4. animal_node - Defines the building blocks of the tree.
  *
+ * Usage:
+ *   app [--record FILE | --replay FILE [--paced]]
+ *
+ *   --record  writes every answer, with its timings, to a transcript FILE
+ *   --replay  plays the answers of a transcript FILE at full speed, then
+ *             compares the output and response times with the recording
+ *   --paced   waits as long as the recorded user did before each answer
+ *
  * Changelog:
  *  - 10/27/2023 - initial design.
  *  - 10/28/2023 - included input and output utils,
@@ -24,6 +32,26 @@
  *  - see other files for changelog, for more detailed information.
  *  - 10/30/2023
  *    - added decisions.
+ *  - 10/19/2026
+ *    - create from database and save tree use tree_io.
+ *    - added show metrics.
+ *    - save tree can run in the background.
+ *    - added memory report.
+ *    - added optimize layout.
+ *    - create from an attribute matrix.
+ *    - added adaptive game.
+ *    - trees can be saved compressed.
+ *    - added paged database.
+ *    - added compact tree, the replaced tree is freed on new tree.
+ *    - print tree replaced by browse tree, a page at a time.
+ *    - added search tree.
+ *    - added apply lessons.
+ *    - added shared memory tree.
+ *    - sessions can be recorded and replayed, see transcript.
+ *    - added diff against a database.
+ *    - lessons of the published tree are copied to the tree.
+ *    - the hashes are verified after apply lessons, compact tree and optimize
+ *      layout.
  *
  * Notes:
  * - The game utilizes a decision tree mechanism for its logic.
@@ -32,13 +60,63 @@
  *
  */
 
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
 
 using namespace std;
 
 #include "input.hpp"
 #include "output.hpp"
+#include "adaptive_engine.hpp"
 #include "animal_tree.hpp"
+#include "attribute_matrix.hpp"
+#include "id3_builder.hpp"
+#include "lesson_batch.hpp"
+#include "metrics.hpp"
+#include "paged_tree.hpp"
+#include "shared_tree.hpp"
+#include "tree_browser.hpp"
+#include "tree_compaction.hpp"
+#include "tree_diff.hpp"
+#include "tree_index.hpp"
+#include "tree_io.hpp"
+#include "tree_layout.hpp"
+#include "tree_memory.hpp"
+#include "tree_saver.hpp"
+#include "transcript.hpp"
+
+// writes snapshots of the tree while the game keeps going
+tree_saver::AsyncSaver background_saver;
+
+// matrix of the adaptive game, loaded the first time it's played
+attribute_matrix::AttributeMatrix adaptive_matrix;
+adaptive_engine::AdaptiveEngine adaptive_game_engine(adaptive_matrix);
+
+// paged database being played, opened on the first paged game
+paged_tree::PagedTree* paged = nullptr;
+const size_t PAGE_CACHE_PAGES = 256;
+
+// tree shared with other processes, published or attached by the menu
+shared_tree::SharedTree* shared = nullptr;
+const size_t SHARED_SPARE_BYTES = 256 << 20;  // only the pages learned into take memory
+
+// index of the tree's text, built on the first search and kept up to date by
+// the tree's flips
+tree_index::TreeIndex* search_index = nullptr;
+
+/**
+ * @brief Drops the search index after the tree was changed other than by
+ * flips, the next search builds a new one.
+ */
+void forget_index(animal_tree::AnimalTree& tree) {
+    if (tree.observer == search_index) {
+        tree.observer = nullptr;
+    }
+    delete search_index;
+    search_index = nullptr;
+}
 
 /**
  * @brief Queries the user if they want to continue playing.
@@ -54,31 +132,108 @@ bool play_again(const string& msg) {
     return !global::fncs::contains(ans, "y");
 }
 
+/**
+ * @brief Finishes the background save and closes the databases, also runs at
+ * exit when the input ends.
+ */
+void close_databases() {
+    if (background_saver.running()) {
+        output::inform("waiting for the background save to finish");
+        background_saver.wait();
+    }
+    delete paged;  // writes back what paged games learned
+    paged = nullptr;
+    delete shared;  // a published tree is unlinked, attached processes keep their copy mapped
+    shared = nullptr;
+}
+
 void exit_game() {
+    close_databases();
     output::goodbye();
     exit(0);
 }
 
+/**
+ * @brief Reads the value of a "--name value" option.
+ *
+ * @return The value, fallback if the option is absent.
+ */
+string option(int argc, char** argv, const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (name == argv[i]) {
+            return argv[i + 1];
+        }
+    }
+    return fallback;
+}
+
+/**
+ * @brief Tells whether the "--name" option was given.
+ */
+bool flag(int argc, char** argv, const string& name) {
+    for (int i = 1; i < argc; i++) {
+        if (name == argv[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Builds a whole tree from an attribute matrix, see id3_builder.
+ *
+ * @return The built tree, a new tree if the matrix can't be read.
+ */
+animal_tree::AnimalTree build_from_matrix() {
+    string file_path = input::line("Enter the path to the attribute matrix: ");
+    attribute_matrix::AttributeMatrix matrix;
+    if (!attribute_matrix::load_file(file_path, matrix)) {
+        output::error("could not read " + file_path + ", starting from scratch");
+        return animal_tree::AnimalTree();
+    }
+    id3_builder::BuildReport report = id3_builder::build(matrix);
+    output::inform("built " + to_string(report.leaves) + " animals, " +
+                   to_string(report.depth) + " questions deep, in " +
+                   to_string(report.seconds) + " s");
+    if (report.dropped) {
+        output::inform(to_string(report.dropped) +
+                       " animals answer like another animal and were left out");
+    }
+    return animal_tree::AnimalTree(report.root);
+}
+
 animal_tree::AnimalTree init_tree() {
     vector<string> selection = {
         "Create from database", 
-        "Create from scratch" 
+        "Create from scratch",
+        "Create from attribute matrix (CSV/TSV)"
     };
     int choice = input::select(global::msgs::DECISION, selection);
     output::separate();
-    animal_tree::AnimalTree tree;
+    animal_tree::AnimalTree tree(nullptr);
     string file_path;
 
     switch (choice) {
-        case 1:
+        case 1: {
             file_path = input::line(global::msgs::INPUT_FILE_PATH);
-            tree = animal_tree::AnimalTree();
+            animal_node::AnimalNode* root = tree_io::load_file(file_path);
+            if (root) {
+                tree = animal_tree::AnimalTree(root);
+            } else {
+                output::error("could not load " + file_path + ", starting from scratch");
+                tree = animal_tree::AnimalTree();
+            }
             break;
+        }
         case 2:
             tree = animal_tree::AnimalTree();
             break;
+        case 3:
+            tree = build_from_matrix();
+            break;
         default:
             output::error("invalid choice");
+            tree = animal_tree::AnimalTree();
             break;
     }
     output::separate();
@@ -86,14 +241,470 @@ animal_tree::AnimalTree init_tree() {
     return tree;
 }
 
+/**
+ * @brief Reports the progress or the outcome of the background save.
+ *
+ * Called before every menu, so completion and failure are reported as soon as
+ * the user is back at the menu.
+ */
+void report_background_save() {
+    switch (background_saver.poll()) {
+        case tree_saver::RUNNING:
+            output::inform("background save to " + background_saver.path() + ": " +
+                           to_string(background_saver.nodes_written()) + "/" +
+                           to_string(background_saver.nodes_total()) + " nodes written");
+            break;
+        case tree_saver::DONE:
+            output::inform("background save to " + background_saver.path() + " completed");
+            break;
+        case tree_saver::FAILED:
+            output::error("background save to " + background_saver.path() + " failed");
+            break;
+        case tree_saver::IDLE:
+            break;
+    }
+}
+
+/**
+ * @brief Saves the tree, either right away or on a background thread.
+ *
+ * @param tree The tree to be saved.
+ */
+void save_tree(const animal_tree::AnimalTree& tree) {
+    string file_path = input::line(global::msgs::INPUT_FILE_PATH);
+    string ans = input::line("Compress the database? (y/n)");
+    tree_io::Format format = global::fncs::contains(ans, "y") ? tree_io::COMPRESSED : tree_io::TEXT;
+    ans = input::line("Save in the background while you keep playing? (y/n)");
+    if (global::fncs::contains(ans, "y")) {
+        if (background_saver.start(tree, file_path, format)) {
+            output::inform("saving in the background");
+        } else {
+            output::error("a background save is still running");
+        }
+    } else if (tree_io::save_file(tree, file_path, nullptr, format)) {
+        output::inform("tree saved");
+    }
+}
+
+/**
+ * @brief Shows the latency metrics and optionally dumps them to a file.
+ *
+ * The dump uses the Prometheus text format so it can be scraped or compared
+ * across releases.
+ */
+void show_metrics() {
+    metrics::print(cout);
+    output::separate();
+    string ans = input::line("Dump metrics to a file? (y/n)");
+    if (!global::fncs::contains(ans, "y")) {
+        return;
+    }
+    string file_path = input::line("Enter the path to the metrics file: ");
+    ofstream metrics_file(file_path.c_str());
+    metrics::dump_prometheus(metrics_file);
+    if (metrics_file) {
+        output::inform("metrics written to " + file_path);
+    } else {
+        output::error("could not write " + file_path);
+    }
+}
+
+/**
+ * @brief Shows how much memory the tree and the whole process use.
+ *
+ * @param tree The tree to be measured.
+ */
+void memory_report(const animal_tree::AnimalTree& tree) {
+    output::inform("current tree");
+    tree_memory::print(tree_memory::measure(tree.root), cout);
+    output::inform("process");
+    tree_memory::print(tree_memory::process_usage(), cout);
+}
+
+/**
+ * @brief Rewrites the tree into a cache friendly order between games.
+ *
+ * @param tree The tree to be laid out again.
+ */
+void optimize_layout(animal_tree::AnimalTree& tree) {
+    vector<string> selection = {
+        "van Emde Boas (any traffic)",
+        "Most played answers first"
+    };
+    int choice = input::select("Which layout?", selection);
+    tree_layout::Layout layout =
+        choice == 1 ? tree_layout::VAN_EMDE_BOAS : tree_layout::HOT_FIRST;
+
+    const size_t PAGE_SIZE = 4096;
+    double lines_before = tree_layout::lines_per_walk(tree.root);
+    double pages_before = tree_layout::lines_per_walk(tree.root, PAGE_SIZE);
+    tree_layout::relayout(tree, layout);
+    forget_index(tree);
+    animal_node::debug::verify_hashes(tree.root, "the relayout");
+    double lines_after = tree_layout::lines_per_walk(tree.root);
+    double pages_after = tree_layout::lines_per_walk(tree.root, PAGE_SIZE);
+    output::inform("cache lines per game: " + to_string(lines_before) + " -> " +
+                   to_string(lines_after));
+    output::inform("pages per game: " + to_string(pages_before) + " -> " + to_string(pages_after));
+}
+
+/**
+ * @brief Plays a game with the adaptive engine instead of the tree.
+ *
+ * The attribute matrix is asked for on the first adaptive game and kept for
+ * the following ones.
+ */
+void play_adaptive_game() {
+    if (adaptive_matrix.animals.empty()) {
+        string file_path = input::line("Enter the path to the attribute matrix: ");
+        if (!attribute_matrix::load_file(file_path, adaptive_matrix)) {
+            output::error("could not read " + file_path);
+            adaptive_matrix = attribute_matrix::AttributeMatrix();
+            return;
+        }
+        output::inform("loaded " + to_string(adaptive_matrix.animals.size()) + " animals and " +
+                       to_string(adaptive_matrix.questions.size()) + " questions");
+        adaptive_game_engine.choices.clear();
+        adaptive_game_engine.prepare();
+    }
+    output::init_game();
+    animal_tree::InteractivePlayer player;
+    animal_tree::GameResult result = adaptive_game_engine.play_game(player);
+    if (!result.guessed) {
+        output::inform("I give up! Your animal isn't in the attribute matrix");
+    }
+}
+
+/**
+ * @brief Splits the tree into a paged database, or plays a game on one
+ * loading only the pages the game goes through.
+ *
+ * @param tree The tree to be split.
+ */
+void paged_database(const animal_tree::AnimalTree& tree) {
+    vector<string> selection = {
+        "Split current tree into pages",
+        "Play a paged game"
+    };
+    int choice = input::select("What to do with the paged database?", selection);
+    string directory = input::line("Enter the directory of the paged database: ");
+
+    if (choice == 1) {
+        size_t pages = paged_tree::split(tree.root, directory);
+        if (pages) {
+            output::inform(to_string(pages) + " pages written to " + directory);
+        }
+        return;
+    }
+    if (!paged || paged->path() != directory) {
+        delete paged;
+        paged = new paged_tree::PagedTree(directory, PAGE_CACHE_PAGES);
+    }
+    if (!paged->valid()) {
+        output::error(directory + " is not a paged database");
+        return;
+    }
+    output::init_game();
+    animal_tree::InteractivePlayer player;
+    paged->play_game(player);
+    paged_tree::PagingStats stats = paged->stats();
+    output::inform(to_string(stats.resident) + " pages in memory, " + to_string(stats.faults) +
+                   " loaded, " + to_string(stats.evictions) + " evicted, " +
+                   to_string(stats.writebacks) + " written back");
+}
+
+// asks the user and remembers the last lesson taught
+struct TeachingPlayer : animal_tree::InteractivePlayer {
+    string guessed;
+    string animal;
+    string question;
+
+    bool teach(const string& wrong_guess, string& new_animal, string& new_question) {
+        if (!animal_tree::InteractivePlayer::teach(wrong_guess, new_animal, new_question)) {
+            return false;
+        }
+        guessed = wrong_guess;
+        animal = new_animal;
+        question = new_question;
+        return true;
+    }
+};
+
+/**
+ * @brief Publishes the tree to shared memory, or plays on a tree another
+ * process published.
+ *
+ * The publishing process is the writer, its games teach the shared tree.
+ * The segment goes away with the writer, so every lesson is also applied to
+ * tree, where it can be saved. Games of attached processes are read only.
+ *
+ * @param tree The tree to be published, and taught what the shared tree learns.
+ */
+void shared_database(animal_tree::AnimalTree& tree) {
+    vector<string> selection = {
+        "Publish current tree",
+        "Play on the shared tree"
+    };
+    int choice = input::select("What to do with the shared tree?", selection);
+    if (choice == 1) {
+        string name = input::line("Enter the name of the shared tree (e.g. /animal_tree): ");
+        delete shared;
+        shared = new shared_tree::SharedTree();
+        if (shared->create(name, tree.root, SHARED_SPARE_BYTES)) {
+            output::inform(to_string(shared->nodes()) + " nodes published to " + name + ", " +
+                           to_string(shared->used() >> 20) + " MB used");
+        }
+        return;
+    }
+    if (!shared || !shared->valid()) {
+        string name = input::line("Enter the name of the shared tree: ");
+        delete shared;
+        shared = new shared_tree::SharedTree();
+        if (!shared->attach(name)) {
+            return;
+        }
+    }
+    output::init_game();
+    TeachingPlayer player;
+    animal_tree::GameResult result = shared->play_game(player);
+    if (result.learned) {
+        animal_node::AnimalNode* leaf = tree.leaf_at(result.path);
+        if (leaf && leaf->str == player.guessed) {
+            tree.learn(leaf, result.path, player.question, player.animal);
+        } else {
+            output::error("the tree changed since it was published, the lesson is only kept by " +
+                          shared->name() + " until it is released");
+        }
+    }
+    output::inform(to_string(shared->nodes()) + " nodes in " + shared->name() +
+                   (shared->writable() ? "" : " (read only)"));
+}
+
+/**
+ * @brief Shows the rows of the browser's window, numbered so the commands
+ * can refer to them.
+ */
+static void print_page(tree_browser::TreeBrowser& browser) {
+    const size_t MAX_INDENT = 32;
+    vector<tree_browser::Row> rows = browser.page();
+    for (size_t i = 0; i < rows.size(); i++) {
+        const tree_browser::Row& row = rows[i];
+        string marker;
+        if (row.node->is_question()) {
+            marker = row.expanded ? "[-] " : "[+] ";
+        }
+        cout << setw(4) << i + 1 << "  " << string(2 * min(row.path.size(), MAX_INDENT), ' ')
+             << (row.path.empty() ? "" : row.path.substr(row.path.size() - 1) + ": ") << marker
+             << (row.node->is_question() ? "Q " : "G ") << row.node->str;
+        if (row.node->is_question() && !row.expanded) {
+            cout << "  (" << row.subtree << (row.subtree >= tree_browser::SIZE_LIMIT ? "+" : "")
+                 << " nodes)";
+        }
+        if (row.path.size() > MAX_INDENT) {
+            cout << "  @" << row.path;
+        }
+        cout << '\n';
+    }
+}
+
+/**
+ * @brief Browses the tree a page at a time, only the shown rows are visited.
+ *
+ * @param tree The tree to be browsed.
+ */
+void browse_tree(const animal_tree::AnimalTree& tree) {
+    const size_t PAGE_ROWS = 20;
+    const string HELP =
+        "n/p: next/previous page, e/c <row>: expand/collapse, g <path>: go to path (y/n...), "
+        "/<text>: search, q: quit";
+    if (!tree.root) {
+        output::error("the tree is empty");
+        return;
+    }
+    tree_browser::TreeBrowser browser(tree.root, PAGE_ROWS);
+    output::inform(HELP);
+    while (true) {
+        print_page(browser);
+        string command = input::line("browse> ");
+        string argument = command.size() > 1 ? command.substr(1) : "";
+        if (!argument.empty() && argument[0] == ' ') {
+            argument = argument.substr(argument.find_first_not_of(' '));
+        }
+        bool ok = true;
+        switch (command[0]) {
+            case 'n':
+                ok = browser.next_page();
+                break;
+            case 'p':
+                ok = browser.previous_page();
+                break;
+            case 'e':
+            case 'c': {
+                vector<tree_browser::Row> rows = browser.page();
+                size_t row = static_cast<size_t>(atoi(argument.c_str()));
+                if (row < 1 || row > rows.size()) {
+                    ok = false;
+                } else if (command[0] == 'e') {
+                    ok = browser.expand(rows[row - 1].path);
+                } else {
+                    ok = browser.collapse(rows[row - 1].path);
+                }
+                break;
+            }
+            case 'g':
+                ok = browser.jump(argument);
+                break;
+            case '/':
+                ok = browser.search(argument);
+                break;
+            case 'q':
+                return;
+            default:
+                output::inform(HELP);
+                break;
+        }
+        if (!ok) {
+            output::error("nothing to do for \"" + command + "\"");
+        }
+    }
+}
+
+/**
+ * @brief Lists the nodes holding a word, or a word starting with a prefix
+ * when the query ends in '*'.
+ *
+ * @param tree The tree to be searched, indexed on the first search.
+ */
+void search_tree(animal_tree::AnimalTree& tree) {
+    const size_t SHOWN_HITS = 20;
+    if (!search_index) {
+        uint64_t started = metrics::now_ns();
+        search_index = new tree_index::TreeIndex(tree.root);
+        tree.observer = search_index;
+        output::inform("indexed " + to_string(search_index->nodes()) + " nodes, " +
+                       to_string(search_index->words()) + " words, in " +
+                       to_string((metrics::now_ns() - started) / 1e9) + " s");
+    }
+    string query = input::line("Search for a word (end it with * for a prefix): ");
+    bool prefix = query[query.size() - 1] == '*';
+    vector<string> words = tree_index::tokenize(query);
+    if (words.size() != 1) {
+        output::error("search for one word at a time");
+        return;
+    }
+
+    vector<tree_index::Hit> hits = prefix ? search_index->find_prefix(words[0], SHOWN_HITS)
+                                          : search_index->find(words[0], SHOWN_HITS);
+    size_t total = prefix ? search_index->count_prefix(words[0]) : search_index->count(words[0]);
+    for (const tree_index::Hit& hit : hits) {
+        cout << (hit.node->is_question() ? "Q " : "G ") << hit.node->str << "  @"
+             << (hit.path.empty() ? "root" : hit.path) << '\n';
+    }
+    output::inform(to_string(total) + " nodes found" +
+                   (total > hits.size() ? ", showing the first " + to_string(hits.size()) : ""));
+}
+
+/**
+ * @brief Teaches the tree every lesson of a lesson file and tells which
+ * ones couldn't be applied.
+ *
+ * @param tree The tree to be taught.
+ */
+void apply_lessons(animal_tree::AnimalTree& tree) {
+    const size_t SHOWN_REJECTIONS = 10;
+    string file_path = input::line("Enter the path to the lesson file: ");
+    vector<lesson_batch::Lesson> lessons;
+    if (!lesson_batch::load_file(file_path, lessons)) {
+        return;
+    }
+    lesson_batch::BatchReport report = lesson_batch::apply(tree, lessons);
+    animal_node::debug::verify_hashes(tree.root, "applying the lessons");
+    output::inform("applied " + to_string(report.applied) + " of " + to_string(lessons.size()) +
+                   " lessons in " + to_string(report.seconds) + " s");
+    if (!report.conflicts.empty()) {
+        output::inform(to_string(report.conflicts.size()) +
+                       " lessons teach an animal another lesson already taught:");
+    }
+    for (size_t i = 0; i < report.conflicts.size() && i < SHOWN_REJECTIONS; i++) {
+        const lesson_batch::Conflict& conflict = report.conflicts[i];
+        cout << "  line " << lessons[conflict.lesson].line << " (" << lessons[conflict.lesson].animal
+             << ") lost to line " << lessons[conflict.applied].line << " ("
+             << lessons[conflict.applied].animal << ")\n";
+    }
+    if (!report.unreachable.empty()) {
+        output::inform(to_string(report.unreachable.size()) +
+                       " lessons have a path that doesn't end at an animal:");
+    }
+    for (size_t i = 0; i < report.unreachable.size() && i < SHOWN_REJECTIONS; i++) {
+        const lesson_batch::Lesson& lesson = lessons[report.unreachable[i]];
+        cout << "  line " << lesson.line << " (" << (lesson.path.empty() ? "-" : lesson.path)
+             << ")\n";
+    }
+}
+
+/**
+ * @brief Compares the tree with a database, e.g. to check that a save holds
+ * everything learned since, and shows what differs.
+ *
+ * @param tree The tree in memory.
+ */
+void diff_tree(const animal_tree::AnimalTree& tree) {
+    const size_t SHOWN_CHANGES = 50;
+    string file_path = input::line(global::msgs::INPUT_FILE_PATH);
+    animal_node::AnimalNode* saved = tree_io::load_file(file_path);
+    if (!saved) {
+        output::error("could not load " + file_path);
+        return;
+    }
+    tree_diff::DiffReport report = tree_diff::diff(saved, tree.root, SHOWN_CHANGES);
+    output::inform("changes from " + file_path + " to the tree in memory:");
+    tree_diff::print(report, cout);
+    animal_node::free_tree(saved);
+}
+
+/**
+ * @brief Removes the questions that no longer tell animals apart and shows
+ * what it saved.
+ *
+ * @param tree The tree to be compacted.
+ */
+void compact_tree(animal_tree::AnimalTree& tree) {
+    tree_compaction::CompactionReport report = tree_compaction::compact(tree);
+    forget_index(tree);
+    animal_node::debug::verify_hashes(tree.root, "the compaction");
+    tree_compaction::print(report, cout);
+}
+
+/**
+ * @brief Replaces the tree with a new one, freeing the old one.
+ *
+ * @param tree The tree to be replaced.
+ */
+void new_tree(animal_tree::AnimalTree& tree) {
+    forget_index(tree);
+    animal_node::free_tree(tree.root);
+    tree = init_tree();
+}
+
 void decide_action(animal_tree::AnimalTree& tree) {
     vector<string> selection = {
         "Play game", 
-        "Print tree", 
+        "Play adaptive game",
+        "Browse tree",
         "Save tree", 
+        "Show metrics",
+        "Memory report",
+        "Optimize layout",
+        "Paged database",
+        "Shared memory tree",
+        "Compact tree",
+        "Search tree",
+        "Apply lessons",
+        "Diff against a database",
         "dile adios al arbol (new tree)",
         "Exit of Game"
     };
+    report_background_save();
     int choice = input::select("Now what?", selection);
     output::separate();
 
@@ -103,17 +714,46 @@ void decide_action(animal_tree::AnimalTree& tree) {
             tree.play_game();
             break;
         case 2:
-            output::inform("printing tree");
-            tree.print_tree(cout);
+            play_adaptive_game();
             break;
         case 3:
-            output::inform("saving tree");
-            output::toDO("save tree");
+            browse_tree(tree);
             break;
         case 4:
-            tree = init_tree();
+            output::inform("saving tree");
+            save_tree(tree);
             break;
         case 5:
+            show_metrics();
+            break;
+        case 6:
+            memory_report(tree);
+            break;
+        case 7:
+            optimize_layout(tree);
+            break;
+        case 8:
+            paged_database(tree);
+            break;
+        case 9:
+            shared_database(tree);
+            break;
+        case 10:
+            compact_tree(tree);
+            break;
+        case 11:
+            search_tree(tree);
+            break;
+        case 12:
+            apply_lessons(tree);
+            break;
+        case 13:
+            diff_tree(tree);
+            break;
+        case 14:
+            new_tree(tree);
+            break;
+        case 15:
             exit_game();
             break;
         default:
@@ -123,7 +763,23 @@ void decide_action(animal_tree::AnimalTree& tree) {
     output::separate();
 }
 
-int main() {
+int main(int argc, char** argv) {
+    string record_path = option(argc, argv, "--record", "");
+    string replay_path = option(argc, argv, "--replay", "");
+    if (!record_path.empty() && !replay_path.empty()) {
+        output::error("--record and --replay can't be used together");
+        return 1;
+    }
+    if (!record_path.empty() && !transcript::start_recording(record_path)) {
+        output::error("could not write the transcript " + record_path);
+        return 1;
+    }
+    if (!replay_path.empty() && !transcript::start_replay(replay_path, flag(argc, argv, "--paced"))) {
+        output::error("could not read the transcript " + replay_path);
+        return 1;
+    }
+    atexit(close_databases);
+
     output::welcome();
     output::separate();
 
@@ -0,0 +1,169 @@
+/*
+ * Animal Traversal Benchmark
+ * file: bench_main.cpp
+ * author: Diego R.R.
+ * date: 10/19/2026
+ * course: CS2337.501
+ *
+ * Purpose:
+ * Measures how many root to animal walks per second tree_traversal gets out of
+ * a tree much larger than the last level cache, one query at a time and with
+ * groups of queries walked in lockstep.
+ *
+ * Usage:
+ *   bench [--animals A] [--queries Q] [--seed S]
+ *
+ *   --animals  animals of the random tree, it has 2A - 1 nodes (default 4194304)
+ *   --queries  walks timed per run (default 1000000)
+ *   --seed     seed of the tree and the queries (default 1)
+ *
+ * Changelog:
+ *  - 10/19/2026 - initial version.
+ *  - 10/19/2026 - the hashes of the tree are verified before it is walked.
+ *
+ * Notes:
+ * - the tree has random shape (every question splits its animals at a
+ *   random point) and its nodes are placed in random order, like a tree grown
+ *   by learning, where a node and its parent are rarely allocated together.
+ * - a query answers a question from the question's hash and the query's
+ *   key, so it reads nothing but the node.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+#include "animal_node.hpp"
+#include "metrics.hpp"
+#include "output.hpp"
+#include "tree_traversal.hpp"
+
+/**
+ * @brief Reads the integer value of a "--name value" option.
+ *
+ * @return The parsed value, fallback if the option is absent.
+ */
+long long option(int argc, char** argv, const string& name, long long fallback) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (name == argv[i]) {
+            return atoll(argv[i + 1]);
+        }
+    }
+    return fallback;
+}
+
+/**
+ * @brief Builds a random tree of animals leaves, its nodes scattered over
+ * one block in random order.
+ *
+ * @return The root of the tree.
+ */
+animal_node::AnimalNode* random_tree(size_t animals, mt19937_64& rng) {
+    size_t nodes = 2 * animals - 1;
+    animal_node::AnimalNode* block = animal_node::alloc_block(nodes);
+    vector<size_t> place(nodes);
+    for (size_t i = 0; i < nodes; i++) {
+        place[i] = i;
+    }
+    shuffle(place.begin(), place.end(), rng);
+
+    struct Open {
+        animal_node::AnimalNode** slot;
+        size_t animals;
+    };
+    animal_node::AnimalNode* root = nullptr;
+    vector<Open> open;
+    Open first = {&root, animals};
+    open.push_back(first);
+    size_t used = 0;
+    size_t animal_id = 0;
+    while (!open.empty()) {
+        Open current = open.back();
+        open.pop_back();
+        animal_node::AnimalNode* node = block + place[used++];
+        *current.slot = node;
+        if (current.animals == 1) {
+            node->str = "a" + to_string(animal_id++);
+            continue;
+        }
+        size_t yes = 1 + rng() % (current.animals - 1);
+        node->str = "q" + to_string(used);
+        Open no_side = {&node->no_branch, current.animals - yes};
+        Open yes_side = {&node->yes_branch, yes};
+        open.push_back(no_side);
+        open.push_back(yes_side);
+    }
+    animal_node::rehash_tree(root);
+    return root;
+}
+
+// answers from the question's hash mixed with the query's key
+struct KeyedAnswer {
+    const uint64_t* keys;
+
+    bool operator()(size_t query, const animal_node::AnimalNode& question) const {
+        return ((question.hash ^ keys[query]) * 0x9e3779b97f4a7c15ULL) >> 63;
+    }
+};
+
+int main(int argc, char** argv) {
+    size_t animals = static_cast<size_t>(option(argc, argv, "--animals", 1 << 22));
+    size_t queries = static_cast<size_t>(option(argc, argv, "--queries", 1000000));
+    mt19937_64 rng(static_cast<uint64_t>(option(argc, argv, "--seed", 1)));
+    if (animals < 2 || queries < 1) {
+        output::error("animals must be at least 2 and queries positive");
+        return 1;
+    }
+
+    output::inform("building a random tree of " + to_string(animals) + " animals");
+    animal_node::AnimalNode* root = random_tree(animals, rng);
+    if (animal_node::debug::verify_hashes(root, "building the tree") != 0) {
+        return 1;  // the walks answer from the hashes
+    }
+    output::inform(to_string((2 * animals - 1) * sizeof(animal_node::AnimalNode) >> 20) +
+                   " MB of nodes");
+
+    vector<uint64_t> keys(queries);
+    for (uint64_t& key : keys) {
+        key = rng();
+    }
+    KeyedAnswer answer = {keys.data()};
+    vector<const animal_node::AnimalNode*> expected(queries);
+    vector<const animal_node::AnimalNode*> leaves(queries);
+
+    // warm up the page tables and the answers the others are checked against
+    tree_traversal::walk_each(root, queries, answer, expected.data());
+
+    uint64_t start = metrics::now_ns();
+    tree_traversal::walk_each(root, queries, answer, leaves.data());
+    double single_ns = static_cast<double>(metrics::now_ns() - start) / queries;
+
+    cout << fixed << setprecision(1);
+    cout << left << setw(16) << "walk" << right << setw(14) << "ns/query" << setw(14)
+         << "Mquery/s" << setw(10) << "speedup" << endl;
+    cout << left << setw(16) << "one at a time" << right << setw(14) << single_ns << setw(14)
+         << 1e3 / single_ns << setw(10) << 1.0 << endl;
+
+    const size_t groups[] = {2, 4, 8, 16, 32, 64};
+    for (size_t group : groups) {
+        start = metrics::now_ns();
+        tree_traversal::walk_interleaved(root, queries, answer, leaves.data(), group);
+        double ns = static_cast<double>(metrics::now_ns() - start) / queries;
+        if (leaves != expected) {
+            output::error("interleaved walk of " + to_string(group) +
+                          " ended at different animals");
+            return 1;
+        }
+        cout << left << setw(16) << ("group of " + to_string(group)) << right << setw(14) << ns
+             << setw(14) << 1e3 / ns << setw(10) << single_ns / ns << endl;
+    }
+
+    animal_node::free_tree(root);
+    return 0;
+}
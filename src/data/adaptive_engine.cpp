@@ -0,0 +1,308 @@
+/*
+ * Adaptive Question Engine Implementation
+ * file: adaptive_engine.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to play the adaptive game
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *
+ * notes:
+ * - scoring a question counts its yes answers among the candidates. While
+ *   most words hold candidates the columns are scanned straight through (the
+ *   loop vectorizes), once candidates are sparse only the words that still
+ *   hold some are visited, through a compacted index/bits list.
+ * - a question that splits the candidates in half can't be beaten, the scan
+ *   stops as soon as one is found.
+ * - the build doesn't target a specific CPU, so on x86 the scan is compiled a
+ *   second time for the popcnt instruction and picked at run time. Without it
+ *   __builtin_popcountll is a library call, several times slower.
+ */
+
+#include "adaptive_engine.hpp"
+
+#include "metrics.hpp"
+
+using namespace std;
+
+namespace adaptive_engine {
+
+    size_t count(const vector<uint64_t>& set) {
+        size_t total = 0;
+        for (uint64_t word : set) {
+            total += __builtin_popcountll(word);
+        }
+        return total;
+    }
+
+    AdaptiveEngine::AdaptiveEngine(const attribute_matrix::AttributeMatrix& matrix)
+        : matrix(matrix) {}
+
+    void AdaptiveEngine::prepare() {
+        if (matrix.animals.empty()) {
+            return;
+        }
+        AdaptiveGame game(*this);
+        game.prepare();
+    }
+
+    /**
+     * @brief Plays an adaptive game, asking until one candidate is left and
+     * guessing the candidates until player confirms one or none are left.
+     *
+     * @param player Answers the questions and guesses.
+     * @return How the game went, learned is always false.
+     */
+    animal_tree::GameResult AdaptiveEngine::play_game(animal_tree::Player& player) {
+        animal_tree::GameResult result;
+        result.questions = 0;
+        result.guessed = false;
+        result.learned = false;
+
+        AdaptiveGame game(*this);
+        while (true) {
+            size_t question = game.next_question();
+            if (question != NONE) {
+                bool yes = player.answer(matrix.questions[question]);
+                game.answer(question, yes);
+                result.questions++;
+                result.path += yes ? 'y' : 'n';
+                continue;
+            }
+            size_t animal = game.best_guess();
+            if (animal == NONE) {
+                return result;
+            }
+            if (player.confirm_guess(matrix.animals[animal])) {
+                result.guessed = true;
+                return result;
+            }
+            game.reject(animal);
+        }
+    }
+
+    AdaptiveGame::AdaptiveGame(AdaptiveEngine& engine)
+        : engine(engine),
+          exact(engine.matrix.words, 0),
+          one_off(engine.matrix.words, 0),
+          exact_count(engine.matrix.animals.size()),
+          one_off_count(0),
+          asked(engine.matrix.questions.size(), false),
+          turns(0),
+          rejected_any(false) {
+        for (size_t a = 0; a < exact_count; a++) {
+            exact[a >> 6] |= 1ULL << (a & 63);
+        }
+    }
+
+    const vector<uint64_t>& AdaptiveGame::active() const {
+        return exact_count > 0 ? exact : one_off;
+    }
+
+    size_t AdaptiveGame::active_count() const {
+        return exact_count > 0 ? exact_count : one_off_count;
+    }
+
+    size_t AdaptiveGame::scan_cost() const {
+        const vector<uint64_t>& set = active();
+        size_t words = 0;
+        for (uint64_t word : set) {
+            words += word != 0;
+        }
+        if (words * 2 > set.size()) {
+            words = set.size();
+        }
+        return words * (asked.size() - turns);
+    }
+
+    // candidates of a turn, as seen by the scan kernel
+    struct Candidates {
+        const vector<uint64_t>& set;
+        size_t count;
+        bool dense;               // scan every word of set
+        vector<uint32_t> index;   // otherwise only these words
+        vector<uint64_t> bits;    // set[index[i]]
+    };
+
+    /**
+     * @brief Finds the unasked question that splits the candidates most evenly.
+     *
+     * Always inlined into the kernels below, so __builtin_popcountll becomes
+     * the popcnt instruction where the kernel's target has it.
+     *
+     * @return The question, NONE if no question splits the candidates.
+     */
+    static inline __attribute__((always_inline)) size_t
+    scan_body(const attribute_matrix::AttributeMatrix& matrix, const vector<bool>& asked,
+              const Candidates& candidates) {
+        const uint64_t* set = candidates.set.data();
+        size_t words = candidates.set.size();
+        size_t best = NONE;
+        size_t best_score = SIZE_MAX;
+        for (size_t q = 0; q < matrix.questions.size(); q++) {
+            if (asked[q]) {
+                continue;
+            }
+            const uint64_t* column = matrix.columns[q].data();
+            size_t yes = 0;
+            if (candidates.dense) {
+                for (size_t w = 0; w < words; w++) {
+                    yes += __builtin_popcountll(column[w] & set[w]);
+                }
+            } else {
+                for (size_t i = 0; i < candidates.index.size(); i++) {
+                    yes += __builtin_popcountll(column[candidates.index[i]] & candidates.bits[i]);
+                }
+            }
+            if (yes == 0 || yes == candidates.count) {
+                continue;
+            }
+            size_t twice = 2 * yes;
+            size_t score =
+                twice > candidates.count ? twice - candidates.count : candidates.count - twice;
+            if (score < best_score) {
+                best_score = score;
+                best = q;
+                if (score <= 1) {
+                    break;
+                }
+            }
+        }
+        return best;
+    }
+
+    static size_t scan_portable(const attribute_matrix::AttributeMatrix& matrix,
+                                const vector<bool>& asked, const Candidates& candidates) {
+        return scan_body(matrix, asked, candidates);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("popcnt"))) static size_t
+    scan_popcnt(const attribute_matrix::AttributeMatrix& matrix, const vector<bool>& asked,
+                const Candidates& candidates) {
+        return scan_body(matrix, asked, candidates);
+    }
+
+    static size_t scan(const attribute_matrix::AttributeMatrix& matrix, const vector<bool>& asked,
+                       const Candidates& candidates) {
+        static const bool has_popcnt = __builtin_cpu_supports("popcnt");
+        return has_popcnt ? scan_popcnt(matrix, asked, candidates)
+                          : scan_portable(matrix, asked, candidates);
+    }
+#else
+    static size_t scan(const attribute_matrix::AttributeMatrix& matrix, const vector<bool>& asked,
+                       const Candidates& candidates) {
+        return scan_portable(matrix, asked, candidates);
+    }
+#endif
+
+    /**
+     * @brief Finds the unasked question that splits set most evenly.
+     *
+     * @param set The candidates.
+     * @return The question, NONE if no question splits set.
+     */
+    size_t AdaptiveGame::choose(const vector<uint64_t>& set) {
+        Candidates candidates = {set, count(set), false, vector<uint32_t>(), vector<uint64_t>()};
+        if (candidates.count < 2) {
+            return NONE;
+        }
+        for (size_t w = 0; w < set.size(); w++) {
+            if (set[w]) {
+                candidates.index.push_back(static_cast<uint32_t>(w));
+                candidates.bits.push_back(set[w]);
+            }
+        }
+        candidates.dense = candidates.index.size() * 2 > set.size();
+        return scan(engine.matrix, asked, candidates);
+    }
+
+    size_t AdaptiveGame::next_question() {
+        metrics::Timer timer(metrics::ADAPTIVE_TURN_LATENCY);
+        return decide();
+    }
+
+    /**
+     * @brief Chooses the next question, through the engine's choices while
+     * the turn is cached.
+     *
+     * @return The question, NONE when it's time to guess.
+     */
+    size_t AdaptiveGame::decide() {
+        if (turns >= CACHED_TURNS || rejected_any) {
+            return choose(active());
+        }
+        unordered_map<string, size_t>::iterator found = engine.choices.find(history);
+        if (found != engine.choices.end()) {
+            return found->second;
+        }
+        size_t question = choose(active());
+        engine.choices[history] = question;
+        return question;
+    }
+
+    /**
+     * @brief Chooses the turns that scan more than PREPARE_COST words for
+     * this game and both answers after it, depth first.
+     *
+     * Not timed as turns, no player is waiting on them.
+     */
+    void AdaptiveGame::prepare() {
+        if (turns >= CACHED_TURNS || rejected_any || scan_cost() <= PREPARE_COST) {
+            return;
+        }
+        size_t question = decide();
+        if (question == NONE) {
+            return;
+        }
+        AdaptiveGame no = *this;
+        no.answer(question, false);
+        no.prepare();
+        answer(question, true);
+        prepare();
+    }
+
+    void AdaptiveGame::answer(size_t question, bool yes) {
+        const vector<uint64_t>& column = engine.matrix.columns[question];
+        exact_count = 0;
+        one_off_count = 0;
+        for (size_t w = 0; w < exact.size(); w++) {
+            uint64_t match = yes ? column[w] : ~column[w];
+            one_off[w] = (one_off[w] & match) | (exact[w] & ~match);
+            exact[w] &= match;
+            exact_count += __builtin_popcountll(exact[w]);
+            one_off_count += __builtin_popcountll(one_off[w]);
+        }
+        asked[question] = true;
+        turns++;
+        history += to_string(question);
+        history += yes ? 'y' : 'n';
+    }
+
+    size_t AdaptiveGame::best_guess() const {
+        const vector<uint64_t>& set = active();
+        for (size_t w = 0; w < set.size(); w++) {
+            if (set[w]) {
+                return w * 64 + __builtin_ctzll(set[w]);
+            }
+        }
+        return NONE;
+    }
+
+    void AdaptiveGame::reject(size_t animal) {
+        uint64_t bit = 1ULL << (animal & 63);
+        if (exact[animal >> 6] & bit) {
+            exact[animal >> 6] &= ~bit;
+            exact_count--;
+        }
+        if (one_off[animal >> 6] & bit) {
+            one_off[animal >> 6] &= ~bit;
+            one_off_count--;
+        }
+        rejected_any = true;
+    }
+
+}  // namespace adaptive_engine
@@ -0,0 +1,111 @@
+/*
+ * Adaptive Question Engine
+ * file: adaptive_engine.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * alternative to the fixed tree of AnimalTree::play_game: the animals and
+ * their answers live in an attribute matrix and every turn asks the question
+ * that splits the remaining candidates best (maximum information gain)
+ *
+ * changelog:
+ *  10/19/2026 - initial design, one wrong answer tolerated
+ *
+ * notes:
+ * - candidates are bitsets over the animals. A question is scored with AND +
+ *   popcount over the words that still hold candidates, so a turn costs
+ *   (unasked questions) x (candidate words) and shrinks as the game goes on.
+ * - the choice of a turn only depends on the answers given before it, so the
+ *   choices of the first CACHED_TURNS turns are remembered by the engine and
+ *   shared by every game. Those are the turns with the most candidates, the
+ *   expensive ones can be chosen before any game with prepare().
+ * - an animal that contradicts one answer is kept aside. If every candidate
+ *   is ruled out, the game carries on with those, so one unexpected answer
+ *   doesn't lose the game.
+ */
+
+#ifndef ADAPTIVE_ENGINE_HPP
+#define ADAPTIVE_ENGINE_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "animal_tree.hpp"
+#include "attribute_matrix.hpp"
+
+using namespace std;
+
+namespace adaptive_engine {
+
+    const size_t NONE = SIZE_MAX;
+    const size_t CACHED_TURNS = 12;
+    const size_t PREPARE_COST = 1 << 18;  // words scanned by a turn worth preparing
+
+    struct AdaptiveEngine {
+        const attribute_matrix::AttributeMatrix& matrix;
+
+        explicit AdaptiveEngine(const attribute_matrix::AttributeMatrix& matrix);
+
+        /*
+         *  chooses ahead of time the cached turns that would scan more than
+         *  PREPARE_COST words, so no game pays for them. Call again after the
+         *  matrix changes (choices must be cleared first)
+         */
+        void prepare();
+
+        // plays a game with player, teaching is not used
+        animal_tree::GameResult play_game(animal_tree::Player& player);
+
+        // remembered choices, keyed by the answers of the turns before them
+        unordered_map<string, size_t> choices;
+    };
+
+    // state of one game
+    struct AdaptiveGame {
+        explicit AdaptiveGame(AdaptiveEngine& engine);
+
+        // question to ask next, NONE when it's time to guess
+        size_t next_question();
+
+        // narrows the candidates with the answer to question
+        void answer(size_t question, bool yes);
+
+        // animal to guess, NONE if there are no candidates left
+        size_t best_guess() const;
+
+        // takes a wrongly guessed animal out of the game
+        void reject(size_t animal);
+
+        size_t candidates() const { return active_count(); }
+
+        // chooses the expensive turns of every game that can follow this one
+        void prepare();
+
+    private:
+        AdaptiveEngine& engine;
+        vector<uint64_t> exact;       // animals matching every answer
+        vector<uint64_t> one_off;     // animals contradicting exactly one answer
+        size_t exact_count;
+        size_t one_off_count;
+        vector<bool> asked;
+        size_t turns;
+        string history;               // question id and answer of every turn
+        bool rejected_any;            // a rejected guess makes history ambiguous
+
+        const vector<uint64_t>& active() const;
+        size_t active_count() const;
+        size_t choose(const vector<uint64_t>& set);
+        size_t decide();
+        size_t scan_cost() const;  // words the scan of the next turn reads
+    };
+
+    // number of animals in a bitset
+    size_t count(const vector<uint64_t>& set);
+
+}  // namespace adaptive_engine
+
+#endif  // ADAPTIVE_ENGINE_HPP
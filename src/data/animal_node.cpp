@@ -13,23 +13,205 @@
  * Key Functions:
  * 1. alloc_question: Allocates memory and sets up a new question node.
  * 2. alloc_animal: Allocates memory and sets up a new animal node.
- * 3. print_node_data: A debug function to print out node information.
+ * 3. free_tree: Releases a whole subtree.
+ * 4. clone_tree: Deep copies a whole subtree.
+ * 5. print_node_data: A debug function to print out node information.
+ * 6. verify_hashes: A debug function to check the merkle hashes of a tree.
  *
  * changelog:
  *  10/29/2023 - initial implementation, added debug function, added alloc functions
+ *  10/19/2026 - added free_tree
+ *  10/19/2026 - added clone_tree
+ *  10/19/2026 - every node goes through new_node/delete_node, which keep the
+ *  live and peak node counters
+ *  10/19/2026 - nodes come from a slab pool, added alloc_block for layouts
+ *  10/19/2026 - added trim_pool
+ *  10/19/2026 - added hash_node and rehash_tree, alloc and clone keep the hashes
+ *  10/19/2026 - added debug::verify_hashes
  *
  * notes:
  * - Ensure proper memory management to avoid memory leaks.
+ * - nodes live in slabs owned by the pool, a freed node goes back to the free
+ *   list of the pool instead of to the system allocator. The pool itself is
+ *   never destroyed so trees freed during program exit stay valid.
  */
 
 #include "animal_node.hpp"
 #include "output.hpp"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <new>
+#include <vector>
 
 using namespace std;
 
 namespace animal_node {
 
+    // nodes per slab when the free list runs dry
+    const size_t SLAB_NODES = 1024;
+
+    struct Slab {
+        AnimalNode* nodes;
+        size_t count;
+    };
+
+    struct Pool {
+        mutex lock;
+        vector<Slab> slabs;
+        vector<AnimalNode*> free_slots;  // raw, unconstructed storage
+        size_t capacity;
+
+        Pool() : capacity(0) {}
+
+        // raw storage for count contiguous nodes, caller holds lock
+        AnimalNode* add_slab(size_t count) {
+            Slab slab;
+            slab.nodes = static_cast<AnimalNode*>(::operator new(count * sizeof(AnimalNode)));
+            slab.count = count;
+            slabs.push_back(slab);
+            capacity += count;
+            return slab.nodes;
+        }
+    };
+
+    static Pool& pool() {
+        static Pool* instance = new Pool;
+        return *instance;
+    }
+
+    static atomic<size_t> live_node_count(0);
+    static atomic<size_t> peak_node_count(0);
+
+    static void count_live(size_t added) {
+        size_t live = live_node_count.fetch_add(added) + added;
+        size_t peak = peak_node_count.load();
+        while (live > peak && !peak_node_count.compare_exchange_weak(peak, live)) {
+        }
+    }
+
+    static AnimalNode* new_node() {
+        Pool& nodes = pool();
+        void* storage;
+        {
+            lock_guard<mutex> guard(nodes.lock);
+            if (nodes.free_slots.empty()) {
+                AnimalNode* slab = nodes.add_slab(SLAB_NODES);
+                for (size_t i = SLAB_NODES; i > 0; i--) {
+                    nodes.free_slots.push_back(slab + i - 1);
+                }
+            }
+            storage = nodes.free_slots.back();
+            nodes.free_slots.pop_back();
+        }
+        AnimalNode* node = new (storage) AnimalNode();
+        count_live(1);
+        return node;
+    }
+
+    static void delete_node(AnimalNode* node) {
+        node->~AnimalNode();
+        Pool& nodes = pool();
+        {
+            lock_guard<mutex> guard(nodes.lock);
+            nodes.free_slots.push_back(node);
+        }
+        live_node_count.fetch_sub(1);
+    }
+
+    /**
+     * @brief Allocates count nodes next to each other in memory.
+     *
+     * The block is a slab of its own, so a layout pass can place a whole tree
+     * in the order it is walked. Nodes of the block are released one by one
+     * through free_node like any other node.
+     *
+     * @param count Number of nodes.
+     * @return The first node of the block, nodes are empty animals.
+     */
+    AnimalNode* alloc_block(size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        Pool& nodes = pool();
+        AnimalNode* block;
+        {
+            lock_guard<mutex> guard(nodes.lock);
+            block = nodes.add_slab(count);
+        }
+        for (size_t i = 0; i < count; i++) {
+            new (block + i) AnimalNode();
+        }
+        count_live(count);
+        return block;
+    }
+
+    void free_node(AnimalNode* node) {
+        delete_node(node);
+    }
+
+    /**
+     * @brief Gives the slabs whose nodes are all free back to the system.
+     *
+     * The free list is sorted by address on the way, so the nodes handed out
+     * next come from the same slabs.
+     *
+     * @return Bytes released.
+     */
+    size_t trim_pool() {
+        Pool& nodes = pool();
+        lock_guard<mutex> guard(nodes.lock);
+        vector<AnimalNode*>& free_slots = nodes.free_slots;
+        sort(free_slots.begin(), free_slots.end());
+
+        size_t released = 0;
+        vector<Slab> kept;
+        vector<bool> dropped(free_slots.size(), false);
+        for (const Slab& slab : nodes.slabs) {
+            size_t first = lower_bound(free_slots.begin(), free_slots.end(), slab.nodes) -
+                           free_slots.begin();
+            size_t last = lower_bound(free_slots.begin() + first, free_slots.end(),
+                                      slab.nodes + slab.count) -
+                          free_slots.begin();
+            if (last - first != slab.count) {
+                kept.push_back(slab);
+                continue;
+            }
+            fill(dropped.begin() + first, dropped.begin() + last, true);
+            ::operator delete(slab.nodes);
+            nodes.capacity -= slab.count;
+            released += slab.count * sizeof(AnimalNode);
+        }
+        size_t remaining = 0;
+        for (size_t i = 0; i < free_slots.size(); i++) {
+            if (!dropped[i]) {
+                free_slots[remaining++] = free_slots[i];
+            }
+        }
+        free_slots.resize(remaining);
+        nodes.slabs.swap(kept);
+        return released;
+    }
+
+    PoolStats pool_stats() {
+        Pool& nodes = pool();
+        lock_guard<mutex> guard(nodes.lock);
+        PoolStats stats;
+        stats.slabs = nodes.slabs.size();
+        stats.capacity = nodes.capacity;
+        stats.free_slots = nodes.free_slots.size();
+        return stats;
+    }
+
+    size_t live_nodes() {
+        return live_node_count.load();
+    }
+
+    size_t peak_live_nodes() {
+        return peak_node_count.load();
+    }
+
     /**
      * @brief Dynamically allocates and initializes a new question node.
      * 
@@ -43,10 +225,12 @@ namespace animal_node {
      * @return Pointer to the dynamically allocated question node.
      */
     AnimalNode* alloc_question(const string& question, AnimalNode* yes, AnimalNode* no) {
-        AnimalNode* node = new AnimalNode;
+        AnimalNode* node = new_node();
         node->str = question;
         node->yes_branch = yes;
         node->no_branch = no;
+        node->visits = 0;
+        node->hash = hash_node(*node);
 
         debug::print_node_data(*node);
 
@@ -64,16 +248,133 @@ namespace animal_node {
      * @return Pointer to the dynamically allocated animal node.
      */
     AnimalNode* alloc_animal(const string& animal) {
-        AnimalNode* node = new AnimalNode;
+        AnimalNode* node = new_node();
         node->str = animal;
         node->yes_branch = nullptr;
         node->no_branch = nullptr;
+        node->visits = 0;
+        node->hash = hash_node(*node);
 
         debug::print_node_data(*node);
 
         return node;
     }
 
+    /**
+     * @brief Releases every node of the subtree rooted at root.
+     *
+     * Walks the subtree with an explicit stack instead of recursion, since trees
+     * grown by the learn-on-miss flow can be deep chains.
+     *
+     * @param root The root of the subtree to be released, may be null.
+     */
+    void free_tree(AnimalNode* root) {
+        vector<AnimalNode*> pending;
+        if (root) {
+            pending.push_back(root);
+        }
+        while (!pending.empty()) {
+            AnimalNode* node = pending.back();
+            pending.pop_back();
+            if (node->yes_branch) {
+                pending.push_back(node->yes_branch);
+            }
+            if (node->no_branch) {
+                pending.push_back(node->no_branch);
+            }
+            delete_node(node);
+        }
+    }
+
+    /**
+     * @brief Deep copies the subtree rooted at root.
+     *
+     * Each pending pair holds a source node and the branch slot its copy
+     * has to be stored in.
+     *
+     * @param root The subtree to be copied, may be null.
+     * @return The root of the copy.
+     */
+    AnimalNode* clone_tree(const AnimalNode* root) {
+        AnimalNode* copy = nullptr;
+        vector<pair<const AnimalNode*, AnimalNode**>> pending;
+        if (root) {
+            pending.push_back(make_pair(root, &copy));
+        }
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back().first;
+            AnimalNode** slot = pending.back().second;
+            pending.pop_back();
+
+            *slot = new_node();
+            (*slot)->str = node->str;
+            (*slot)->yes_branch = nullptr;
+            (*slot)->no_branch = nullptr;
+            (*slot)->visits = node->visits;
+            (*slot)->hash = node->hash;
+            if (node->yes_branch) {
+                pending.push_back(make_pair(node->yes_branch, &(*slot)->yes_branch));
+            }
+            if (node->no_branch) {
+                pending.push_back(make_pair(node->no_branch, &(*slot)->no_branch));
+            }
+        }
+        return copy;
+    }
+
+    /**
+     * @brief FNV-1a over a tag telling questions from animals, the text and,
+     * for questions, the hashes of the yes and no branches.
+     *
+     * FNV is used rather than std::hash so the hashes of a tree are the same
+     * in every build and process.
+     *
+     * @param node The node, its branches must already be hashed.
+     * @return The hash of the subtree rooted at node.
+     */
+    uint64_t hash_node(const AnimalNode& node) {
+        const uint64_t FNV_PRIME = 1099511628211ULL;
+        uint64_t hash = 14695981039346656037ULL;
+        hash = (hash ^ (node.is_question() ? 'Q' : 'G')) * FNV_PRIME;
+        for (char c : node.str) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+        }
+        if (node.is_question()) {
+            uint64_t branches[] = {node.yes_branch->hash, node.no_branch->hash};
+            for (uint64_t branch : branches) {
+                for (int byte = 0; byte < 8; byte++) {
+                    hash = (hash ^ ((branch >> (byte * 8)) & 0xff)) * FNV_PRIME;
+                }
+            }
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Hashes every node of the subtree in postorder, used after a tree
+     * was built or changed other than through flips.
+     *
+     * @param root The subtree to be hashed, may be null.
+     */
+    void rehash_tree(AnimalNode* root) {
+        vector<pair<AnimalNode*, bool>> pending;
+        if (root) {
+            pending.push_back(make_pair(root, false));
+        }
+        while (!pending.empty()) {
+            AnimalNode* node = pending.back().first;
+            bool branches_done = pending.back().second;
+            pending.pop_back();
+            if (node->is_question() && !branches_done) {
+                pending.push_back(make_pair(node, true));
+                pending.push_back(make_pair(node->no_branch, false));
+                pending.push_back(make_pair(node->yes_branch, false));
+            } else {
+                node->hash = hash_node(*node);
+            }
+        }
+    }
+
     /**
      * @brief Debug function to print node data.
      * 
@@ -106,5 +407,46 @@ namespace animal_node {
         }
     }
 
+    /**
+     * @brief Debug function to check the merkle hashes of a subtree, without
+     * changing them.
+     *
+     * Every node's hash is compared with hash_node of its text and its
+     * branches' stored hashes. If no node fails that, every hash is the one
+     * rehash_tree would compute, from the animals up.
+     *
+     * @param root The subtree to be checked, may be null.
+     * @param after What last changed the tree, for the error messages.
+     * @return Number of nodes with a stale hash.
+     */
+    size_t debug::verify_hashes(const AnimalNode* root, const string& after) {
+        const size_t SHOWN_STALE = 5;
+        size_t stale = 0;
+        vector<pair<const AnimalNode*, string>> pending;
+        if (root) {
+            pending.push_back(make_pair(root, string()));
+        }
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back().first;
+            string path = pending.back().second;
+            pending.pop_back();
+            if (node->hash != hash_node(*node)) {
+                if (stale < SHOWN_STALE) {
+                    output::error("stale hash after " + after + " at path \"" + path + "\" (" +
+                                  node->str + ")");
+                }
+                stale++;
+            }
+            if (node->is_question()) {
+                pending.push_back(make_pair(node->no_branch, path + 'n'));
+                pending.push_back(make_pair(node->yes_branch, path + 'y'));
+            }
+        }
+        if (stale > SHOWN_STALE) {
+            output::error(to_string(stale) + " stale hashes after " + after);
+        }
+        return stale;
+    }
+
 }  // namespace animal_node
 
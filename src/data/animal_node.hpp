@@ -10,11 +10,20 @@
  *
  * changelog:
  *  10/29/2023 - started animal node design
+ *  10/19/2026 - added free_tree
+ *  10/19/2026 - added clone_tree
+ *  10/19/2026 - live and peak node counters
+ *  10/19/2026 - visit counters, nodes come from a pool, contiguous blocks
+ *  10/19/2026 - pool trimming
+ *  10/19/2026 - merkle hash of every subtree
+ *  10/19/2026 - added debug::verify_hashes
  */
 
 #ifndef ANIMAL_NODE_HPP
 #define ANIMAL_NODE_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include "global.hpp"
@@ -30,6 +39,8 @@ namespace animal_node {
         string str;  // Question or animal
         AnimalNode* yes_branch;     // Pointer to 'Yes' branch
         AnimalNode* no_branch;      // Pointer to 'No' branch
+        uint64_t hash;              // hash_node of the subtree, see rehash_tree
+        unsigned visits;            // games that went through this node
         
         bool is_question() const {
             return yes_branch && no_branch;
@@ -49,11 +60,74 @@ namespace animal_node {
      */
     AnimalNode* alloc_animal(const string& animal);
 
+    /*
+     *  releases every node of the subtree rooted at root
+     */
+    void free_tree(AnimalNode* root);
+
+    /*
+     *  deep copy of the subtree rooted at root
+     */
+    AnimalNode* clone_tree(const AnimalNode* root);
+
+    /*
+     *  hash of the node's text and its branches' hashes, so equal hashes mean
+     *  (barring collisions) equal subtrees. The branches' hashes must be
+     *  up to date.
+     */
+    uint64_t hash_node(const AnimalNode& node);
+
+    /*
+     *  recomputes the hash of every node of the subtree, bottom up
+     */
+    void rehash_tree(AnimalNode* root);
+
+    /*
+     *  count nodes next to each other in memory, each one is an empty animal
+     *  and is released on its own through free_node
+     */
+    AnimalNode* alloc_block(size_t count);
+
+    /*
+     *  releases a single node, its branches are left alone
+     */
+    void free_node(AnimalNode* node);
+
+    /*
+     *  state of the node pool, shared by every tree
+     */
+    struct PoolStats {
+        size_t slabs;
+        size_t capacity;    // nodes the slabs can hold
+        size_t free_slots;  // nodes ready to be reused
+    };
+
+    PoolStats pool_stats();
+
+    /*
+     *  returns the slabs with no live node to the system, in bytes
+     */
+    size_t trim_pool();
+
+    /*
+     *  nodes currently allocated by this module, across every tree
+     */
+    size_t live_nodes();
+
+    /*
+     *  highest live_nodes() seen since the program started
+     */
+    size_t peak_live_nodes();
+
     /*
      *  Debug routines
      */
     namespace debug {
         void print_node_data(const AnimalNode& node, const string& opt = "");
+
+        // nodes of the subtree whose hash is stale, each one reported with
+        // after (what last changed the tree), 0 if every hash is up to date
+        size_t verify_hashes(const AnimalNode* root, const string& after);
     }  // namespace debug
 
 }  // namespace animal_node
@@ -9,15 +9,26 @@
  *
  * changelog:
  *  10/29/2023 - initial implementation
+ *  10/19/2026 - added constructor from an existing root
+ *  10/19/2026 - play_game is iterative and driven by a Player
+ *  10/19/2026 - turn and flip latencies recorded into metrics
+ *  10/19/2026 - play_game counts the visits of every node it goes through
+ *  10/19/2026 - added learn
+ *  10/19/2026 - flips are reported to the tree's observer
+ *  10/19/2026 - added leaf_at
+ *  10/19/2026 - flips rehash their path, added rehash_path
+ *  10/19/2026 - added TreeGenerations
  *
  * notes:
  */
 
 #include "animal_tree.hpp"
 #include <iostream>
+#include <vector>
 #include "animal_node.hpp"
 #include "global.hpp"
 #include "input.hpp"
+#include "metrics.hpp"
 #include "output.hpp"
 
 using namespace std;
@@ -28,75 +39,169 @@ namespace animal_tree {
     /**
      * @brief Default constructor. Initializes the tree with a default guess of "lizard".
      */
-    AnimalTree::AnimalTree() {
+    AnimalTree::AnimalTree() : observer(nullptr), hash_flips(true), restructures(0) {
         root = animal_node::alloc_animal("lizard");
     }
 
     /**
-     * @brief Starts the animal guessing game.
+     * @brief Wraps an already built tree, e.g. one loaded by tree_io.
+     *
+     * @param root The root of the tree, must not be null.
+     */
+    AnimalTree::AnimalTree(AnimalNode* root)
+        : root(root), observer(nullptr), hash_flips(true), restructures(0) {}
+
+    /**
+     * @brief Starts the animal guessing game with the user.
      *
      * Initiates the game, which will traverse the tree. Asking the user 
      * questions until it reaches a guess or needs to expand its knowledge, its 
      * handled by main.
      */
     void AnimalTree::play_game() {
-        play_game(root);
+        InteractivePlayer player;
+        play_game(player);
     }
 
     /**
-     * @brief Recursive function to traverse the tree and play the game.
+     * @brief Traverses the tree and plays the game with the given player.
+     *
+     * While the current node is a question, the player answers it and the game
+     * moves to the corresponding branch. Once an animal is reached the game makes
+     * a guess, if it is wrong the tree tries to expand its knowledge.
      *
-     * If the current node is a question, it asks the user the question and 
-     * moves to the corresponding branch based on the answer. If it's an animal, 
-     * the game makes a guess. If the guess is wrong, the game tries to expand its knowledge.
+     * The walk is a loop rather than a recursion, a tree grown by the
+     * learn-on-miss flow can be deeper than the call stack allows. The time from
+     * each answer to the next prompt is recorded as the turn latency.
      *
-     * @param node The current node in the traversal.
+     * @param player Who answers the questions.
+     * @return How the game went.
      */
-    void AnimalTree::play_game(AnimalNode* node) {
+    GameResult AnimalTree::play_game(Player& player) {
+        GameResult result;
+        result.questions = 0;
+        result.guessed = false;
+        result.learned = false;
+
+        AnimalNode* node = root;
         if (!node) {
             output::error("Traversing a null node");
-            return;
+            return result;
         }
 
-        if (node->is_question()) {
-            string question = node->str;
-            string ans = input::line(question);
-            if (global::fncs::contains(ans, "y")) {
-                play_game(node->yes_branch);
-            } else {
-                play_game(node->no_branch);
+        uint64_t answered_at = 0;
+        while (node->is_question()) {
+            debug::inspecting_node(*node);
+            node->visits++;
+            result.questions++;
+            if (answered_at) {
+                metrics::record(metrics::TURN_LATENCY, metrics::now_ns() - answered_at);
             }
-        } else {
-            // Guess the animal
-            string guess = "Is it a(n) " + node->str + "? (y/n)";
-            string ans = input::line(guess);
-
-            if (global::fncs::contains(ans, "y")) {
-                output::inform("Yay! I guessed right!");
+            bool yes = player.answer(node->str);
+            answered_at = metrics::now_ns();
+            if (yes) {
+                result.path += 'y';
+                node = node->yes_branch;
             } else {
-                expand_animal_guess(node);
+                result.path += 'n';
+                node = node->no_branch;
             }
         }
+
+        // Guess the animal
+        node->visits++;
+        if (answered_at) {
+            metrics::record(metrics::TURN_LATENCY, metrics::now_ns() - answered_at);
+        }
+        if (player.confirm_guess(node->str)) {
+            result.guessed = true;
+        } else {
+            result.learned = expand_animal_guess(node, result.path, player);
+        }
+        return result;
     }
 
     /**
      * @brief Expands the tree with a new animal and differentiating question.
      *
-     * When the game fails to guess the correct animal, it asks the user for 
+     * When the game fails to guess the correct animal, it asks the player for 
      * the correct animal and a question that differentiates it from the guessed one. 
      * The tree then expands its knowledge using this information.
      *
      * @param animal_node The incorrect guessed animal node to be expanded.
+     * @param path Answers that led to animal_node.
+     * @param player Who teaches the tree.
+     * @return True if the tree was expanded.
      */
-    void AnimalTree::expand_animal_guess(AnimalNode*& animal_node) {
-        string correct_animal = input::line("What animal were you thinking of?");
-        string diff = input::line("What question identifies " + animal_node->str + " from " +
-                                  correct_animal + "? (yes for " + correct_animal + ")");
+    bool AnimalTree::expand_animal_guess(AnimalNode*& animal_node, const string& path,
+                                         Player& player) {
+        string correct_animal;
+        string diff;
+        if (!player.teach(animal_node->str, correct_animal, diff)) {
+            return false;
+        }
 
-        flip_to_question(animal_node, diff, correct_animal);
+        flip_to_question(animal_node, path, diff, correct_animal);
+        return true;
+    }
 
-        output::inform("Thanks for teaching me!");
-        output::separate();
+    /**
+     * @brief Teaches the tree a new animal at a leaf reached outside play_game.
+     *
+     * @param leaf The wrongly guessed animal node, must still be an animal.
+     * @param path Answers from the root to leaf.
+     * @param question Question that is yes for animal and no for the guess.
+     * @param animal The animal the player thought of.
+     */
+    void AnimalTree::learn(AnimalNode* leaf, const string& path, const string& question,
+                           const string& animal) {
+        flip_to_question(leaf, path, question, animal);
+    }
+
+    /**
+     * @brief Follows path from the root, e.g. the path of a GameResult.
+     *
+     * @param path 'y' or 'n' per question answered.
+     * @return The animal path ends at, nullptr if path doesn't end at one.
+     */
+    AnimalNode* AnimalTree::leaf_at(const string& path) const {
+        AnimalNode* node = root;
+        for (size_t i = 0; node && i < path.size(); i++) {
+            if (!node->is_question() || (path[i] != 'y' && path[i] != 'n')) {
+                return nullptr;
+            }
+            node = path[i] == 'y' ? node->yes_branch : node->no_branch;
+        }
+        return node && node->is_animal() ? node : nullptr;
+    }
+
+    /**
+     * @brief Brings the merkle hashes up to date after the node at path changed.
+     *
+     * Only the nodes on the path can have a stale hash, they are rehashed
+     * from the bottom up, O(depth) rather than O(nodes).
+     *
+     * @param path 'y' or 'n' per question from the root to the changed node.
+     */
+    void AnimalTree::rehash_path(const string& path) {
+        vector<AnimalNode*> on_path;
+        AnimalNode* node = root;
+        for (size_t i = 0; node && i < path.size(); i++) {
+            if (!node->is_question() || (path[i] != 'y' && path[i] != 'n')) {
+                node = nullptr;
+                break;
+            }
+            on_path.push_back(node);
+            node = path[i] == 'y' ? node->yes_branch : node->no_branch;
+        }
+        if (!node) {
+            rehash_tree(root);
+            return;
+        }
+        on_path.push_back(node);
+        for (size_t i = on_path.size(); i > 0; i--) {
+            on_path[i - 1]->hash = hash_node(*on_path[i - 1]);
+        }
     }
 
     /**
@@ -107,18 +212,92 @@ namespace animal_tree {
      * guessed animal and the correct animal provided by the user.
      *
      * @param animal_node The animal node to be transformed.
+     * @param path Answers from the root to animal_node, for the observer.
      * @param question The differentiating question.
      * @param correct_animal The correct animal guessed by the user.
      */
-    void AnimalTree::flip_to_question(AnimalNode*& animal_node, const string& question,
-                                      const string& correct_animal) {
+    void AnimalTree::flip_to_question(AnimalNode*& animal_node, const string& path,
+                                      const string& question, const string& correct_animal) {
+        metrics::Timer timer(metrics::FLIP_LATENCY);
         AnimalNode* yes_node = alloc_animal(correct_animal);
         AnimalNode* no_node = alloc_animal(animal_node->str);
         animal_node->str = question;
         animal_node->yes_branch = yes_node;
         animal_node->no_branch = no_node;
+        if (hash_flips) {
+            rehash_path(path);
+        }
 
         debug::flip_to_question(*animal_node);
+        if (observer) {
+            observer->on_flip(animal_node, path);
+        }
+    }
+
+    TreeGenerations::~TreeGenerations() {
+        for (Generation& generation : generations) {
+            free_tree(generation.tree->root);
+            delete generation.tree;
+        }
+    }
+
+    void TreeGenerations::replace(AnimalNode* root) {
+        Generation next = {new AnimalTree(root), 0};
+        generations.push_back(next);
+        free_unused();
+    }
+
+    AnimalTree& TreeGenerations::acquire() {
+        generations.back().games++;
+        return *generations.back().tree;
+    }
+
+    void TreeGenerations::release(AnimalTree& tree) {
+        for (Generation& generation : generations) {
+            if (generation.tree == &tree) {
+                generation.games--;
+                break;
+            }
+        }
+        free_unused();
+    }
+
+    // frees the replaced versions no game is playing on anymore
+    void TreeGenerations::free_unused() {
+        size_t kept = 0;
+        for (size_t i = 0; i < generations.size(); i++) {
+            if (i + 1 < generations.size() && generations[i].games == 0) {
+                free_tree(generations[i].tree->root);
+                delete generations[i].tree;
+            } else {
+                generations[kept++] = generations[i];
+            }
+        }
+        generations.resize(kept);
+    }
+
+    bool InteractivePlayer::answer(const string& question) {
+        string ans = input::line(question);
+        return global::fncs::contains(ans, "y");
+    }
+
+    bool InteractivePlayer::confirm_guess(const string& animal) {
+        string ans = input::line("Is it a(n) " + animal + "? (y/n)");
+        if (global::fncs::contains(ans, "y")) {
+            output::inform("Yay! I guessed right!");
+            return true;
+        }
+        return false;
+    }
+
+    bool InteractivePlayer::teach(const string& guessed, string& animal, string& question) {
+        animal = input::line("What animal were you thinking of?");
+        question = input::line("What question identifies " + guessed + " from " + animal +
+                               "? (yes for " + animal + ")");
+
+        output::inform("Thanks for teaching me!");
+        output::separate();
+        return true;
     }
 
     // public print tree function
@@ -10,13 +10,22 @@
  *
  * changelog:
  *  10/29/2023 - started animal tree design
- 
+ *  10/19/2026 - added constructor from an existing root
+ *  10/19/2026 - games are driven by a Player, play_game reports a GameResult
+ *  10/19/2026 - learn, for games driven from outside (see game_session)
+ *  10/19/2026 - TreeObserver, told about every flip (see tree_index)
+ *  10/19/2026 - leaf_at, lessons addressed by path (see lesson_batch)
+ *  10/19/2026 - flips carry the path of the flipped leaf
+ *  10/19/2026 - flips keep the merkle hashes of their path up to date
+ *  10/19/2026 - restructures count, see depth_watchdog
+ *  10/19/2026 - TreeGenerations, versions of a tree kept until their games end
  */
 
 #ifndef ANIMAL_TREE_HPP
 #define ANIMAL_TREE_HPP
 
 #include <fstream>
+#include <vector>
 #include "animal_node.hpp"
 
 using namespace std;
@@ -24,27 +33,92 @@ using namespace std;
 
 namespace animal_tree {
 
+    /*
+     * Answers the prompts of a game. InteractivePlayer asks the user through
+     * the console, other players (e.g. the simulation oracles) answer on their own.
+     */
+    struct Player {
+        virtual ~Player() {}
+
+        // answer to a question node
+        virtual bool answer(const string& question) = 0;
+
+        // true if the guessed animal is the one the player thought of
+        virtual bool confirm_guess(const string& animal) = 0;
+
+        // fills the animal the player thought of and a question that is yes
+        // for it and no for guessed, returns false to skip teaching
+        virtual bool teach(const string& guessed, string& animal, string& question) = 0;
+    };
+
+    // player that asks the user through input::line
+    struct InteractivePlayer : Player {
+        bool answer(const string& question);
+        bool confirm_guess(const string& animal);
+        bool teach(const string& guessed, string& animal, string& question);
+    };
+
+    /*
+     * Told about the changes of a tree, e.g. to keep an index of it up to date.
+     * Called from the thread that made the change, right after it.
+     */
+    struct TreeObserver {
+        virtual ~TreeObserver() {}
+
+        // question, at path from the root, was an animal, that animal is now its no branch
+        virtual void on_flip(const animal_node::AnimalNode* question, const string& path) = 0;
+    };
+
+    // outcome of one game
+    struct GameResult {
+        int questions;  // question nodes answered before the guess
+        bool guessed;   // the guess was right
+        bool learned;   // the tree was expanded with a new animal
+        string path;    // answers from the root to the guess, 'y' or 'n' per question
+    };
+
     struct AnimalTree {
         animal_node::AnimalNode* root;
+        TreeObserver* observer;  // not owned, nullptr if none
+        bool hash_flips;         // flips rehash their path, see rehash_path
+        size_t restructures;     // subtrees rebuilt so far, see depth_watchdog
 
         // Default constructor
         AnimalTree();
 
-        // traverse the tree and play the game
+        // takes ownership of an already built tree
+        explicit AnimalTree(animal_node::AnimalNode* root);
+
+        // traverse the tree and play the game with the user
         void play_game();
 
+        // traverse the tree and play the game with player
+        GameResult play_game(Player& player);
+
+        // turns the animal leaf (reached by path) into question, yes for animal and
+        // no for the old guess
+        void learn(animal_node::AnimalNode* leaf, const string& path, const string& question,
+                   const string& animal);
+
+        // animal reached by path ('y'/'n' per question), nullptr if path
+        // stops at a question or goes past an animal
+        animal_node::AnimalNode* leaf_at(const string& path) const;
+
+        // rehashes the node path leads to and every question above it, the
+        // whole tree if path doesn't lead anywhere
+        void rehash_path(const string& path);
+
         // print tree to ofstream 
         void print_tree(ostream& output_file);
     private:
-        // Recursive function to traverse the tree and play the game
-        void play_game(animal_node::AnimalNode* root);
-
         // see cpp
-        void expand_animal_guess(animal_node::AnimalNode*& current_node);
+        bool expand_animal_guess(animal_node::AnimalNode*& current_node, const string& path,
+                                 Player& player);
 
         // see cpp
         void flip_to_question(
                 animal_node::AnimalNode*& animal_node,
+                const string& path,
                 const string& question, 
                 const string& correct_animal
         );
@@ -53,6 +127,43 @@ namespace animal_tree {
         void print_tree(ostream& output_stream, animal_node::AnimalNode* root, int level);
     }; 
 
+    /*
+     * Versions of a tree replacing each other while games are played on it
+     * (see replication and tree_reload). New games get the newest version, a
+     * replaced one is freed once the last game on it is released.
+     */
+    struct TreeGenerations {
+        TreeGenerations() {}
+
+        // frees every version
+        ~TreeGenerations();
+
+        // makes root (which it now owns) the version new games get
+        void replace(animal_node::AnimalNode* root);
+
+        // newest version for a new game, release it when the game is over
+        AnimalTree& acquire();
+        void release(AnimalTree& tree);
+
+        // newest version, acquire and current need one replace first
+        AnimalTree& current() { return *generations.back().tree; }
+
+        size_t versions() const { return generations.size(); }  // still in use
+
+    private:
+        struct Generation {
+            AnimalTree* tree;
+            size_t games;
+        };
+
+        vector<Generation> generations;  // back() is the newest
+
+        TreeGenerations(const TreeGenerations&);
+        TreeGenerations& operator=(const TreeGenerations&);
+
+        void free_unused();
+    };
+
     // Debug routines
     namespace debug {
         void print_tree(const AnimalTree& tree);
@@ -0,0 +1,189 @@
+/*
+ * Attribute Matrix Implementation
+ * file: attribute_matrix.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to read an attribute matrix
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *
+ * notes:
+ * - columns grow a word at a time while rows are read, so the number of
+ *   animals doesn't have to be known up front.
+ */
+
+#include "attribute_matrix.hpp"
+
+#include <strings.h>
+
+#include <cstring>
+
+#include "output.hpp"
+
+using namespace std;
+
+namespace attribute_matrix {
+
+    /**
+     * @brief Splits a line into fields, honoring '"' quotes for CSV.
+     *
+     * @param line The line to be split.
+     * @param separator ',' or '\t'.
+     * @param fields Receives the fields.
+     */
+    static void split(const string& line, char separator, vector<string>& fields) {
+        fields.clear();
+        string field;
+        bool quoted = false;
+        for (size_t i = 0; i < line.size(); i++) {
+            char ch = line[i];
+            if (separator == ',' && ch == '"') {
+                if (quoted && i + 1 < line.size() && line[i + 1] == '"') {
+                    field += '"';
+                    i++;
+                } else {
+                    quoted = !quoted;
+                }
+            } else if (ch == separator && !quoted) {
+                fields.push_back(field);
+                field.clear();
+            } else if (ch != '\r') {
+                field += ch;
+            }
+        }
+        fields.push_back(field);
+    }
+
+    /**
+     * @brief Reads the yes/no cell line[begin, end) without copying it.
+     *
+     * Rows can have thousands of cells, so cells are classified in place.
+     *
+     * @param value Receives the answer.
+     * @return False if the cell isn't a recognized answer.
+     */
+    static bool parse_answer(const string& line, size_t begin, size_t end, bool& value) {
+        while (begin < end && (line[begin] == ' ' || line[begin] == '"')) {
+            begin++;
+        }
+        while (end > begin && (line[end - 1] == ' ' || line[end - 1] == '"' ||
+                               line[end - 1] == '\r')) {
+            end--;
+        }
+        static const char* YES[] = {"1", "y", "yes", "true"};
+        static const char* NO[] = {"0", "n", "no", "false"};
+        size_t length = end - begin;
+        for (int i = 0; i < 4; i++) {
+            if (length == strlen(YES[i]) && strncasecmp(line.c_str() + begin, YES[i], length) == 0) {
+                value = true;
+                return true;
+            }
+            if (length == strlen(NO[i]) && strncasecmp(line.c_str() + begin, NO[i], length) == 0) {
+                value = false;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Parses an attribute matrix.
+     *
+     * @param input_stream The CSV or TSV text.
+     * @param matrix Receives the matrix.
+     * @return False if the matrix is malformed.
+     */
+    bool load(istream& input_stream, AttributeMatrix& matrix) {
+        matrix = AttributeMatrix();
+        matrix.words = 0;
+
+        string line;
+        if (!getline(input_stream, line)) {
+            output::error("attribute matrix is empty");
+            return false;
+        }
+        char separator = line.find('\t') != string::npos ? '\t' : ',';
+        vector<string> fields;
+        split(line, separator, fields);
+        if (fields.size() < 2) {
+            output::error("attribute matrix has no question columns");
+            return false;
+        }
+        matrix.questions.assign(fields.begin() + 1, fields.end());
+        matrix.columns.assign(matrix.questions.size(), vector<uint64_t>());
+
+        size_t line_number = 1;
+        while (getline(input_stream, line)) {
+            line_number++;
+            if (line.empty() || line == "\r") {
+                continue;
+            }
+            // the animal may be quoted, every other cell is a plain answer
+            size_t name_end = 0;
+            bool quoted = false;
+            while (name_end < line.size() && (quoted || line[name_end] != separator)) {
+                if (separator == ',' && line[name_end] == '"') {
+                    quoted = !quoted;
+                }
+                name_end++;
+            }
+            split(line.substr(0, name_end), separator, fields);
+
+            size_t animal = matrix.animals.size();
+            if ((animal >> 6) >= matrix.words) {
+                matrix.words++;
+                for (vector<uint64_t>& column : matrix.columns) {
+                    column.push_back(0);
+                }
+            }
+            matrix.animals.push_back(fields[0]);
+
+            size_t begin = name_end + 1;
+            for (size_t q = 0; q < matrix.questions.size(); q++) {
+                if (begin > line.size()) {
+                    output::error("line " + to_string(line_number) + " has " + to_string(q + 1) +
+                                  " fields, expected " + to_string(matrix.questions.size() + 1));
+                    return false;
+                }
+                size_t end = line.find(separator, begin);
+                if (end == string::npos) {
+                    end = line.size();
+                }
+                bool value;
+                if (!parse_answer(line, begin, end, value)) {
+                    output::error("line " + to_string(line_number) + ": \"" +
+                                  line.substr(begin, end - begin) + "\" is not a yes/no answer");
+                    return false;
+                }
+                if (value) {
+                    matrix.columns[q][animal >> 6] |= 1ULL << (animal & 63);
+                }
+                begin = end + 1;
+            }
+            if (begin <= line.size()) {
+                output::error("line " + to_string(line_number) + " has more than " +
+                              to_string(matrix.questions.size() + 1) + " fields");
+                return false;
+            }
+        }
+
+        if (matrix.animals.empty()) {
+            output::error("attribute matrix has no animals");
+            return false;
+        }
+        return true;
+    }
+
+    bool load_file(const string& path, AttributeMatrix& matrix) {
+        ifstream input_file(path.c_str());
+        if (!input_file) {
+            output::error("could not open " + path);
+            return false;
+        }
+        return load(input_file, matrix);
+    }
+
+}  // namespace attribute_matrix
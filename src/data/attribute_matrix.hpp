@@ -0,0 +1,52 @@
+/*
+ * Attribute Matrix
+ * file: attribute_matrix.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * animals x yes/no attributes, read from a CSV or TSV file and stored as one
+ * bitset per attribute (question)
+ *
+ * The first row holds a label for the animal column followed by the question
+ * of every attribute column. Every other row holds an animal followed by its
+ * answers: 1/0, y/n, yes/no or true/false (any case). CSV fields can be
+ * quoted with '"' to hold commas. The separator is a tab if the first row has
+ * one, a comma otherwise.
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ */
+
+#ifndef ATTRIBUTE_MATRIX_HPP
+#define ATTRIBUTE_MATRIX_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace attribute_matrix {
+
+    struct AttributeMatrix {
+        vector<string> animals;
+        vector<string> questions;
+        size_t words;                     // 64 bit words per column
+        vector<vector<uint64_t>> columns;  // columns[q] bit a: answer of animal a to q
+
+        bool answer(size_t animal, size_t question) const {
+            return (columns[question][animal >> 6] >> (animal & 63)) & 1;
+        }
+    };
+
+    // parses the matrix, returns false (after reporting why) if it is malformed
+    bool load(istream& input_stream, AttributeMatrix& matrix);
+
+    bool load_file(const string& path, AttributeMatrix& matrix);
+
+}  // namespace attribute_matrix
+
+#endif  // ATTRIBUTE_MATRIX_HPP
@@ -0,0 +1,579 @@
+/*
+ * Depth Watchdog Implementation
+ * file: depth_watchdog.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to keep the depth of a learning tree bounded
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - games past max_depth are checked too, the walk goes on up
+ *  past the subtrees a rebuild couldn't bring within max_depth, lessons no
+ *  rebuild makes room for are taken back
+ */
+
+#include "depth_watchdog.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_set>
+
+#include "output.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace depth_watchdog {
+
+    const signed char UNKNOWN = -1;
+
+    // fewest questions that tell animals apart
+    static size_t questions_needed(size_t animals) {
+        size_t questions = 0;
+        while ((static_cast<size_t>(1) << questions) < animals) {
+            questions++;
+        }
+        return questions;
+    }
+
+    static AnimalNode* node_at(AnimalNode* root, const string& path) {
+        AnimalNode* node = root;
+        for (size_t i = 0; node && i < path.size(); i++) {
+            node = node->is_question() ? (path[i] == 'y' ? node->yes_branch : node->no_branch)
+                                       : nullptr;
+        }
+        return node;
+    }
+
+    Watchdog::Watchdog(animal_tree::AnimalTree& tree, const Limits& limits)
+        : tree(tree),
+          limits(limits),
+          restructures_done(0),
+          answers_recorded(0),
+          lessons_taken_back(0) {}
+
+    bool Watchdog::worth_restructuring(size_t depth, const Shape& shape) const {
+        size_t fewest = questions_needed(shape.animals);
+        if (shape.height > fewest + limits.max_imbalance) {
+            return true;
+        }
+        return depth + shape.height > limits.max_depth && depth + fewest <= limits.max_depth;
+    }
+
+    /**
+     * @brief Measures the subtree rooted at node.
+     */
+    static void measure(const AnimalNode* node, size_t& animals, size_t& height) {
+        animals = 0;
+        height = 0;
+        vector<pair<const AnimalNode*, size_t>> pending;
+        pending.push_back(make_pair(node, 0));
+        while (!pending.empty()) {
+            const AnimalNode* current = pending.back().first;
+            size_t depth = pending.back().second;
+            pending.pop_back();
+            if (current->is_question()) {
+                pending.push_back(make_pair(current->yes_branch, depth + 1));
+                pending.push_back(make_pair(current->no_branch, depth + 1));
+            } else {
+                animals++;
+                height = max(height, depth);
+            }
+        }
+    }
+
+    /**
+     * @brief Checks the subtrees above the leaf the game ended at after a
+     * lesson or a game that took more than max_depth questions, and takes the
+     * lesson back if it left a game past max_depth no rebuild could fix.
+     *
+     * @param result The game.
+     */
+    void Watchdog::after_game(const animal_tree::GameResult& result) {
+        if (!result.learned && result.path.size() <= limits.max_depth) {
+            return;
+        }
+        AnimalNode* flipped = result.learned ? node_at(tree.root, result.path) : nullptr;
+        const AnimalNode* taught = flipped ? flipped->yes_branch : nullptr;
+        if (bring_within(result.path) || !taught) {
+            return;
+        }
+        flipped = node_at(tree.root, result.path);
+        if (flipped && flipped->is_question() && flipped->yes_branch == taught) {
+            take_back(result.path, flipped);  // a rebuild that moved it has its own path
+        }
+    }
+
+    /**
+     * @brief Rebuilds the subtrees above the node at path, lowest first,
+     * until the ones holding it fit within max_depth.
+     *
+     * Each step up adds the sibling subtree to the measure, so the cost is
+     * the size of the highest subtree looked at, at most max_animals animals.
+     * The walk stops at the first subtree worth a rebuild, or at the first
+     * one the lesson didn't make deeper: neither it nor the ones above can
+     * break a limit they didn't break before. While path's side is past
+     * max_depth it goes on up instead, a larger subtree has more room to fit
+     * its animals in, unless the one it couldn't rebuild waits for answers.
+     *
+     * @param path Path of a leaf, e.g. the game's.
+     * @return True if path's side of the subtrees is within max_depth.
+     */
+    bool Watchdog::bring_within(const string& path) {
+        vector<AnimalNode*> line;  // line[d] is at depth d on the path
+        AnimalNode* node = tree.root;
+        line.push_back(node);
+        for (size_t i = 0; i < path.size() && node->is_question(); i++) {
+            node = path[i] == 'y' ? node->yes_branch : node->no_branch;
+            line.push_back(node);
+        }
+
+        Shape shape;
+        measure(line.back(), shape.animals, shape.height);
+        bool within = line.size() - 1 + shape.height <= limits.max_depth;  // path's side
+        for (size_t depth = line.size(); depth-- > 0;) {
+            if (depth + 1 < line.size()) {
+                // line below depth is stale after a rebuild, the path isn't
+                AnimalNode* parent = line[depth];
+                Shape sibling;
+                measure(path[depth] == 'y' ? parent->no_branch : parent->yes_branch,
+                        sibling.animals, sibling.height);
+                if (sibling.height >= shape.height && within) {
+                    return true;
+                }
+                shape.animals += sibling.animals;
+                shape.height = 1 + max(shape.height, sibling.height);
+            }
+            if (shape.animals > limits.max_animals) {
+                return within;
+            }
+            if (!worth_restructuring(depth, shape)) {
+                continue;
+            }
+            string subtree = path.substr(0, depth);
+            if (!flags.count(subtree) && restructure(subtree)) {
+                measure(line[depth] = node_at(tree.root, subtree), shape.animals, shape.height);
+                within = depth + shape.height <= limits.max_depth;
+            }
+            if (within || flags.count(subtree)) {
+                return within;  // rebuilding one above would drop the answers it waits on
+            }
+        }
+        return within;
+    }
+
+    /**
+     * @brief Turns the question a lesson made at path back into the animal
+     * it replaced.
+     *
+     * The answers the lesson gave about both animals are kept for the
+     * rebuilds, the player teaches the animal again on its next game and by
+     * then the flagged subtrees above may have made room for it.
+     *
+     * @param path Path of the question.
+     * @param question The question, its yes branch is the animal taught.
+     */
+    void Watchdog::take_back(const string& path, AnimalNode* question) {
+        unordered_map<string, bool>& taught = knowledge[question->yes_branch->str];
+        AnimalNode* node = tree.root;
+        for (size_t i = 0; i < path.size(); i++) {
+            taught[node->str] = path[i] == 'y';
+            node = path[i] == 'y' ? node->yes_branch : node->no_branch;
+        }
+        taught[question->str] = true;
+        knowledge[question->no_branch->str][question->str] = false;
+
+        question->str = question->no_branch->str;
+        free_node(question->yes_branch);
+        free_node(question->no_branch);
+        question->yes_branch = nullptr;
+        question->no_branch = nullptr;
+        tree.rehash_path(path);
+        tree.restructures++;
+        lessons_taken_back++;
+    }
+
+    /**
+     * @brief Rebuilds the lowest subtrees worth it anywhere in the tree.
+     *
+     * One postorder walk: a subtree is rebuilt if it is worth it and none of
+     * the subtrees below it is, so the subtrees rebuilt never nest and each
+     * rebuild leaves the paths of the others alone.
+     *
+     * @return The number of subtrees rebuilt.
+     */
+    size_t Watchdog::check_all() {
+        struct Frame {
+            AnimalNode* node;
+            int stage;  // branches walked
+            Shape yes;
+            Shape no;
+            bool below;  // a subtree under it is rebuilt
+        };
+        vector<string> lowest;
+        vector<Frame> stack;
+        string path;
+        Frame first = {tree.root, 0, {0, 0}, {0, 0}, false};
+        stack.push_back(first);
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+            if (top.node->is_question() && top.stage < 2) {
+                bool yes = top.stage++ == 0;
+                path += yes ? 'y' : 'n';
+                Frame child = {yes ? top.node->yes_branch : top.node->no_branch, 0,
+                               {0, 0}, {0, 0}, false};
+                stack.push_back(child);
+                continue;
+            }
+            Shape shape = {1, 0};
+            if (top.node->is_question()) {
+                shape.animals = top.yes.animals + top.no.animals;
+                shape.height = 1 + max(top.yes.height, top.no.height);
+            }
+            bool picked = !top.below && shape.animals <= limits.max_animals &&
+                          worth_restructuring(path.size(), shape);
+            if (picked) {
+                lowest.push_back(path);
+            }
+            bool below = top.below || picked;
+            stack.pop_back();
+            if (!stack.empty()) {
+                Frame& parent = stack.back();
+                (path[path.size() - 1] == 'y' ? parent.yes : parent.no) = shape;
+                parent.below = parent.below || below;
+                path.erase(path.size() - 1);
+            }
+        }
+
+        size_t rebuilt = 0;
+        for (const string& subtree : lowest) {
+            rebuilt += restructure(subtree);
+        }
+        return rebuilt;
+    }
+
+    /**
+     * @brief Rebuilds the subtree at path from the answers known about its
+     * animals, and flags it for more answers if it still breaks a limit.
+     *
+     * known is question major (known[q * animals + a]) so scoring a question
+     * reads one run of bytes.
+     *
+     * @param path Path of the subtree from the root.
+     * @return True if the subtree was replaced by a shorter one.
+     */
+    bool Watchdog::restructure(const string& path) {
+        unflag_below(path);
+        AnimalNode* old_root = node_at(tree.root, path);
+        if (!old_root || !old_root->is_question()) {
+            return false;
+        }
+
+        // animals, questions and the answers on every animal's path
+        struct Visit {
+            AnimalNode* node;
+            size_t depth;
+            size_t parent;  // question index
+            bool yes;
+        };
+        struct Trail {
+            size_t question;
+            bool yes;
+        };
+        vector<AnimalNode*> animals;
+        vector<AnimalNode*> questions;
+        vector<Trail> trail;
+        vector<pair<size_t, Trail>> on_paths;  // animal, answer
+        size_t old_height = 0;
+        vector<Visit> pending;
+        Visit first = {old_root, 0, 0, false};
+        pending.push_back(first);
+        while (!pending.empty()) {
+            Visit visit = pending.back();
+            pending.pop_back();
+            trail.resize(visit.depth);
+            if (visit.depth > 0) {
+                Trail step = {visit.parent, visit.yes};
+                trail[visit.depth - 1] = step;
+            }
+            if (visit.node->is_question()) {
+                size_t q = questions.size();
+                questions.push_back(visit.node);
+                Visit no = {visit.node->no_branch, visit.depth + 1, q, false};
+                Visit yes = {visit.node->yes_branch, visit.depth + 1, q, true};
+                pending.push_back(no);
+                pending.push_back(yes);
+                continue;
+            }
+            for (const Trail& step : trail) {
+                on_paths.push_back(make_pair(animals.size(), step));
+            }
+            animals.push_back(visit.node);
+            old_height = max(old_height, visit.depth);
+        }
+
+        size_t n = animals.size();
+        size_t m = questions.size();
+        vector<signed char> known(n * m, UNKNOWN);
+        for (const pair<size_t, Trail>& answer : on_paths) {
+            known[answer.second.question * n + answer.first] = answer.second.yes;
+        }
+        unordered_map<string, vector<size_t>> by_text;
+        for (size_t q = 0; q < m; q++) {
+            by_text[questions[q]->str].push_back(q);
+        }
+        for (size_t a = 0; a < n; a++) {
+            unordered_map<string, unordered_map<string, bool>>::const_iterator collected =
+                knowledge.find(animals[a]->str);
+            if (collected == knowledge.end()) {
+                continue;
+            }
+            for (const pair<const string, bool>& answer : collected->second) {
+                unordered_map<string, vector<size_t>>::const_iterator same =
+                    by_text.find(answer.first);
+                if (same == by_text.end()) {
+                    continue;
+                }
+                for (size_t q : same->second) {
+                    if (known[q * n + a] == UNKNOWN) {
+                        known[q * n + a] = answer.second;
+                    }
+                }
+            }
+        }
+
+        // ID3 over the questions fully known for each node's animals
+        struct Part {
+            vector<uint32_t> members;
+            AnimalNode** slot;
+            size_t depth;
+        };
+        AnimalNode* new_root = nullptr;
+        size_t new_height = 0;
+        vector<AnimalNode*> built;
+        vector<Part> parts;
+        Part all = {vector<uint32_t>(n), &new_root, 0};
+        for (size_t a = 0; a < n; a++) {
+            all.members[a] = static_cast<uint32_t>(a);
+        }
+        parts.push_back(all);
+        while (!parts.empty()) {
+            Part part;
+            part.members.swap(parts.back().members);
+            part.slot = parts.back().slot;
+            part.depth = parts.back().depth;
+            parts.pop_back();
+            new_height = max(new_height, part.depth);
+            size_t count = part.members.size();
+            if (count == 1) {
+                *part.slot = animals[part.members[0]];
+                continue;
+            }
+
+            size_t best = SIZE_MAX;
+            size_t best_score = SIZE_MAX;
+            for (size_t q = 0; q < m && best_score > count % 2; q++) {
+                const signed char* column = &known[q * n];
+                size_t yes = 0;
+                bool complete = true;
+                for (uint32_t a : part.members) {
+                    if (column[a] == UNKNOWN) {
+                        complete = false;
+                        break;
+                    }
+                    yes += column[a];
+                }
+                if (!complete || yes == 0 || yes == count) {
+                    continue;
+                }
+                size_t score = 2 * yes > count ? 2 * yes - count : count - 2 * yes;
+                if (score < best_score) {
+                    best = q;
+                    best_score = score;
+                }
+            }
+            if (best == SIZE_MAX) {
+                // can't happen, the lowest common question is always known
+                output::error("could not rebuild the subtree at " + path);
+                for (AnimalNode* question : built) {
+                    free_node(question);
+                }
+                return false;
+            }
+
+            AnimalNode* question = alloc_animal(questions[best]->str);
+            built.push_back(question);
+            *part.slot = question;
+            Part yes_part = {vector<uint32_t>(), &question->yes_branch, part.depth + 1};
+            Part no_part = {vector<uint32_t>(), &question->no_branch, part.depth + 1};
+            const signed char* column = &known[best * n];
+            for (uint32_t a : part.members) {
+                (column[a] ? yes_part : no_part).members.push_back(a);
+                question->visits += animals[a]->visits;
+            }
+            parts.push_back(no_part);
+            parts.push_back(yes_part);
+        }
+
+        bool shorter = new_height < old_height;
+        if (shorter) {
+            if (path.empty()) {
+                tree.root = new_root;
+            } else {
+                AnimalNode* parent = node_at(tree.root, path.substr(0, path.size() - 1));
+                (path[path.size() - 1] == 'y' ? parent->yes_branch : parent->no_branch) = new_root;
+            }
+            rehash_tree(new_root);
+            tree.rehash_path(path);
+            tree.restructures++;
+            restructures_done++;
+        }
+        flag(path, questions, animals, known, shorter ? new_height : old_height);
+        // the questions left out of the tree are only freed now, flag reads their text
+        for (AnimalNode* question : shorter ? questions : built) {
+            free_node(question);
+        }
+        return shorter;
+    }
+
+    /**
+     * @brief Queues the questions whose answers the subtree at path still
+     * misses, if it still breaks a limit.
+     *
+     * @param known Answers of every animal to every question, see restructure.
+     * @param height Height of the subtree now.
+     */
+    void Watchdog::flag(const string& path, const vector<AnimalNode*>& questions,
+                        const vector<AnimalNode*>& animals, const vector<signed char>& known,
+                        size_t height) {
+        size_t n = animals.size();
+        size_t m = questions.size();
+        Shape shape = {n, height};
+        if (!worth_restructuring(path.size(), shape)) {
+            return;
+        }
+
+        // ask first for the questions splitting the animals most evenly by
+        // the answers known so far, then for the ones closest to fully known
+        vector<size_t> missing(m, 0);
+        vector<size_t> uneven(m, 0);  // |yes - no| of the known answers
+        for (size_t q = 0; q < m; q++) {
+            size_t yes = 0;
+            for (size_t a = 0; a < n; a++) {
+                missing[q] += known[q * n + a] == UNKNOWN;
+                yes += known[q * n + a] == 1;
+            }
+            size_t no = n - missing[q] - yes;
+            uneven[q] = yes > no ? yes - no : no - yes;
+        }
+        vector<size_t> order;
+        for (size_t q = 0; q < m; q++) {
+            if (missing[q] > 0) {
+                order.push_back(q);
+            }
+        }
+        stable_sort(order.begin(), order.end(), [n, &missing, &uneven](size_t a, size_t b) {
+            // uneven over known, compared without dividing
+            size_t left = uneven[a] * (n - missing[b]);
+            size_t right = uneven[b] * (n - missing[a]);
+            return left != right ? left < right : missing[a] < missing[b];
+        });
+
+        Flag flag;
+        flag.answers = 0;
+        flag.wanted = 0;
+        for (size_t a = 0; a < n; a++) {
+            Want want;
+            want.flag = path;
+            unordered_set<string> queued;
+            for (size_t i = 0; i < order.size() && want.questions.size() < WANTS_PER_ANIMAL;
+                 i++) {
+                const string& text = questions[order[i]]->str;
+                if (known[order[i] * n + a] == UNKNOWN && queued.insert(text).second) {
+                    want.questions.push_back(text);
+                }
+            }
+            if (want.questions.empty()) {
+                continue;
+            }
+            reverse(want.questions.begin(), want.questions.end());
+            flag.wanted += want.questions.size();
+            flag.animals.push_back(animals[a]->str);
+            wants[animals[a]->str] = want;
+        }
+        if (flag.wanted > 0) {
+            flags[path] = flag;
+        }
+    }
+
+    /**
+     * @brief Drops the flags of path and of every subtree under it, with the
+     * questions they wait on.
+     */
+    void Watchdog::unflag_below(const string& path) {
+        map<string, Flag>::iterator flag = flags.lower_bound(path);
+        while (flag != flags.end() && flag->first.compare(0, path.size(), path) == 0) {
+            for (const string& animal : flag->second.animals) {
+                unordered_map<string, Want>::iterator want = wants.find(animal);
+                if (want != wants.end() && want->second.flag == flag->first) {
+                    wants.erase(want);
+                }
+            }
+            flag = flags.erase(flag);
+        }
+    }
+
+    /**
+     * @brief Tries the flagged subtree again once it got an answer for about
+     * half of its animals, or has nothing left to ask.
+     */
+    void Watchdog::settle(const string& path) {
+        map<string, Flag>::iterator flag = flags.find(path);
+        if (flag == flags.end()) {
+            return;
+        }
+        if (flag->second.wanted == 0 || 2 * flag->second.answers > flag->second.animals.size()) {
+            string subtree = path;  // path may belong to the flag
+            restructure(subtree);
+        }
+    }
+
+    bool Watchdog::question_for(const string& animal, string& question) {
+        unordered_map<string, Want>::iterator want = wants.find(animal);
+        if (want == wants.end()) {
+            return false;
+        }
+        unordered_map<string, unordered_map<string, bool>>::const_iterator collected =
+            knowledge.find(animal);
+        Flag& flag = flags[want->second.flag];
+        vector<string>& queued = want->second.questions;
+        while (!queued.empty()) {
+            question = queued.back();
+            queued.pop_back();
+            flag.wanted--;
+            if (collected == knowledge.end() || !collected->second.count(question)) {
+                return true;
+            }
+        }
+        settle(want->second.flag);
+        return false;
+    }
+
+    void Watchdog::record(const string& animal, const string& question, bool yes) {
+        knowledge[animal][question] = yes;
+        answers_recorded++;
+        unordered_map<string, Want>::iterator want = wants.find(animal);
+        if (want == wants.end()) {
+            return;
+        }
+        map<string, Flag>::iterator flag = flags.find(want->second.flag);
+        if (flag == flags.end()) {
+            return;
+        }
+        flag->second.answers++;
+        settle(flag->first);
+    }
+
+}  // namespace depth_watchdog
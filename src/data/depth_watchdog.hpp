@@ -0,0 +1,137 @@
+/*
+ * Depth Watchdog
+ * file: depth_watchdog.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * keeps the questions per game bounded while a tree learns: every lesson
+ * adds its question right above the wrong guess, so busy parts of the tree
+ * grow into long chains. The watchdog rebuilds the subtrees that get too
+ * deep or too unbalanced, one small subtree at a time, while games go on
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *  10/19/2026 - games past max_depth are checked too, lessons no rebuild
+ *  makes room for are taken back
+ *
+ * notes:
+ * - after a lesson, or a game that took more than max_depth questions, the
+ *   subtrees above its leaf are measured from the bottom up, and the lowest
+ *   one that breaks a limit a rebuild could meet is rebuilt: too deep
+ *   (depth + height > max_depth, while its animals would fit in what is
+ *   left) or too unbalanced (height > the fewest questions its animals need
+ *   + max_imbalance). If the leaf is still too deep the next one up is
+ *   tried. Subtrees of more than max_animals animals are left alone, so one
+ *   rebuild never holds the tree for long.
+ * - a lesson whose new leaves stay past max_depth is taken back, the wrong
+ *   guess is an animal again. What it taught is kept for the rebuilds and
+ *   the subtrees above ask players for the rest, the animal is taught
+ *   again on its next game. A tree that starts within max_depth so never
+ *   asks more questions than that, rebuilds only make subtrees shorter.
+ * - a rebuild is ID3 (see id3_builder) over the subtree's animals and
+ *   questions, using only the questions every animal of a node has a known
+ *   answer to. The tree knows the answers on each animal's own path, which
+ *   always leaves the lowest common question of the node's animals, so the
+ *   rebuild never fails, but a chain can't be rebuilt any better than itself
+ *   from those alone. The other answers are collected from players: after a
+ *   right guess a game may ask one of them about the player's animal
+ *   (question_for / record). A subtree that still breaks a limit keeps
+ *   asking and is tried again once enough answers came in.
+ * - the animal nodes are kept, only the questions are replaced. The tree's
+ *   restructures count goes up so the games inside the subtree find their
+ *   place again (see game_session).
+ * - observers are not told about rebuilds, so a watched tree can't be
+ *   replicated or indexed.
+ */
+
+#ifndef DEPTH_WATCHDOG_HPP
+#define DEPTH_WATCHDOG_HPP
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "animal_node.hpp"
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace depth_watchdog {
+
+    const size_t DEFAULT_IMBALANCE = 4;
+    const size_t DEFAULT_MAX_ANIMALS = 1024;
+    const size_t WANTS_PER_ANIMAL = 8;  // questions queued per animal of a flagged subtree
+
+    struct Limits {
+        size_t max_depth;      // questions a game should never need more of
+        size_t max_imbalance;  // questions a subtree may take over the fewest it needs
+        size_t max_animals;    // animals of the largest subtree rebuilt at once
+    };
+
+    struct Watchdog {
+        Watchdog(animal_tree::AnimalTree& tree, const Limits& limits);
+
+        // checks the subtrees above the leaf the game ended at if it taught
+        // the tree or took more than max_depth questions, call after every game
+        void after_game(const animal_tree::GameResult& result);
+
+        // checks every subtree, e.g. after loading a tree. Returns the number rebuilt
+        size_t check_all();
+
+        // question to ask a player whose animal was just guessed, false if
+        // the watchdog needs nothing about it
+        bool question_for(const string& animal, string& question);
+
+        // the player's answer to question_for
+        void record(const string& animal, const string& question, bool yes);
+
+        size_t restructured() const { return restructures_done; }
+        size_t answers() const { return answers_recorded; }
+        size_t flagged() const { return flags.size(); }
+        size_t taken_back() const { return lessons_taken_back; }
+
+    private:
+        struct Shape {
+            size_t animals;
+            size_t height;  // questions on the longest path
+        };
+
+        // subtree that still breaks a limit, waiting for answers
+        struct Flag {
+            vector<string> animals;
+            size_t answers;  // recorded since the last rebuild
+            size_t wanted;   // questions queued and not asked yet
+        };
+
+        struct Want {
+            string flag;               // path of the flagged subtree
+            vector<string> questions;  // the next one to ask last
+        };
+
+        animal_tree::AnimalTree& tree;
+        Limits limits;
+        unordered_map<string, unordered_map<string, bool>> knowledge;  // by animal, question
+        map<string, Flag> flags;                                     // by path
+        unordered_map<string, Want> wants;                           // by animal
+        size_t restructures_done;
+        size_t answers_recorded;
+        size_t lessons_taken_back;
+
+        bool worth_restructuring(size_t depth, const Shape& shape) const;
+        bool bring_within(const string& path);
+        void take_back(const string& path, animal_node::AnimalNode* question);
+        bool restructure(const string& path);
+        void flag(const string& path, const vector<animal_node::AnimalNode*>& questions,
+                  const vector<animal_node::AnimalNode*>& animals, const vector<signed char>& known,
+                  size_t height);
+        void unflag_below(const string& path);
+        void settle(const string& path);
+    };
+
+}  // namespace depth_watchdog
+
+#endif  // DEPTH_WATCHDOG_HPP
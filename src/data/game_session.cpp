@@ -0,0 +1,201 @@
+/*
+ * Game Session Implementation
+ * file: game_session.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to play a game one answer at a time
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - read only sessions
+ *  10/19/2026 - survey questions and restructures, see depth_watchdog
+ */
+
+#include "game_session.hpp"
+
+#include "global.hpp"
+#include "metrics.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace game_session {
+
+    /**
+     * @brief Starts a game at the root of tree.
+     *
+     * @param tree The tree the game is played on, must outlive the session.
+     * @param can_learn False to end the game on a wrong guess.
+     * @param watchdog Watchdog of the tree, nullptr if it has none.
+     */
+    GameSession::GameSession(animal_tree::AnimalTree& tree, bool can_learn,
+                             depth_watchdog::Watchdog* watchdog)
+        : tree(tree), can_learn(can_learn), watchdog(watchdog), node(nullptr),
+          restructures(tree.restructures) {
+        game_result.questions = 0;
+        game_result.guessed = false;
+        game_result.learned = false;
+        if (!tree.root) {
+            finish("The tree is empty");
+            return;
+        }
+        enter(tree.root);
+    }
+
+    /**
+     * @brief Moves the game to next, asking it if it's a question and guessing
+     * it otherwise.
+     *
+     * @param next The node reached.
+     */
+    void GameSession::enter(AnimalNode* next) {
+        node = next;
+        node->visits++;
+        restructures = tree.restructures;
+        if (node->is_question()) {
+            current_state = ASKING;
+            game_result.questions++;
+            pending_prompt = node->str;
+        } else {
+            current_state = GUESSING;
+            guess = node->str;
+            pending_prompt = "Is it a(n) " + guess + "? (y/n)";
+        }
+    }
+
+    void GameSession::finish(const string& closing) {
+        current_state = DONE;
+        pending_prompt = closing;
+        if (watchdog) {
+            watchdog->after_game(game_result);
+        }
+    }
+
+    /**
+     * @brief Finds the game's place again after the watchdog rebuilt part
+     * of the tree, node may be gone.
+     *
+     * @param answer The answer being fed.
+     * @return True if answer is still to be fed to the current prompt.
+     */
+    bool GameSession::catch_up(const string& answer) {
+        bool yes = global::fncs::contains(answer, "y");
+        if (current_state == ASKING) {
+            Answered given = {pending_prompt, yes};
+            answered.push_back(given);
+        }
+
+        string path;
+        AnimalNode* reached = tree.root;
+        while (reached->is_question()) {
+            size_t i = answered.size();
+            while (i > 0 && answered[i - 1].question != reached->str) {
+                i--;
+            }
+            if (i == 0) {
+                break;
+            }
+            path += answered[i - 1].yes ? 'y' : 'n';
+            reached = answered[i - 1].yes ? reached->yes_branch : reached->no_branch;
+        }
+        game_result.path = path;
+        restructures = tree.restructures;
+
+        if (current_state != ASKING && reached->is_animal() && reached->str == guess) {
+            node = reached;
+            return true;
+        }
+        if (current_state == GUESSING && yes) {
+            return true;  // a right guess doesn't need node
+        }
+        enter(reached);  // a lesson in progress is asked again
+        return false;
+    }
+
+    // trim_whitespace can't take blank strings
+    static string trimmed(const string& answer) {
+        if (answer.find_first_not_of(' ') == string::npos) {
+            return "";
+        }
+        return global::fncs::trim_whitespace(answer);
+    }
+
+    /**
+     * @brief Answers the pending prompt.
+     *
+     * Yes/no prompts count as yes when the answer contains a 'y', like
+     * InteractivePlayer. Empty animals and questions are asked again.
+     *
+     * @param answer The player's answer, without the line break.
+     */
+    void GameSession::feed(const string& answer) {
+        if (watchdog && restructures != tree.restructures && current_state != SURVEY &&
+            current_state != DONE && !catch_up(answer)) {
+            return;
+        }
+        switch (current_state) {
+            case ASKING: {
+                metrics::Timer timer(metrics::TURN_LATENCY);
+                bool yes = global::fncs::contains(answer, "y");
+                if (watchdog) {
+                    Answered given = {node->str, yes};
+                    answered.push_back(given);
+                }
+                game_result.path += yes ? 'y' : 'n';
+                enter(yes ? node->yes_branch : node->no_branch);
+                break;
+            }
+            case GUESSING:
+                if (global::fncs::contains(answer, "y")) {
+                    game_result.guessed = true;
+                    if (watchdog && watchdog->question_for(guess, survey_question)) {
+                        current_state = SURVEY;
+                        pending_prompt = "Yay! I guessed right! One more for my notes, about the " +
+                                         guess + ": " + survey_question;
+                    } else {
+                        finish("Yay! I guessed right!");
+                    }
+                } else if (node->is_question()) {
+                    // taught by another session while waiting, keep asking
+                    enter(node);
+                } else if (!can_learn) {
+                    finish("You win! I can't learn new animals here");
+                } else {
+                    current_state = ASK_ANIMAL;
+                    pending_prompt = "What animal were you thinking of?";
+                }
+                break;
+            case ASK_ANIMAL:
+                animal = trimmed(answer);
+                if (!animal.empty()) {
+                    current_state = ASK_QUESTION;
+                    pending_prompt = "What question identifies " + node->str + " from " + animal +
+                                     "? (yes for " + animal + ")";
+                }
+                break;
+            case ASK_QUESTION: {
+                string question = trimmed(answer);
+                if (question.empty()) {
+                    break;
+                }
+                if (node->is_question()) {
+                    enter(node);
+                    break;
+                }
+                tree.learn(node, game_result.path, question, animal);
+                game_result.learned = true;
+                finish("Thanks for teaching me!");
+                break;
+            }
+            case SURVEY:
+                watchdog->record(guess, survey_question, global::fncs::contains(answer, "y"));
+                finish("Thanks, that helps me guess with fewer questions!");
+                break;
+            case DONE:
+                break;
+        }
+    }
+
+}  // namespace game_session
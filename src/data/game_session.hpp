@@ -0,0 +1,99 @@
+/*
+ * Game Session
+ * file: game_session.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * one game of AnimalTree as a state machine that is fed the player's answers
+ * instead of reading them, so a game can be paused between any two prompts
+ * and many games can run over the same tree (see the server)
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *  10/19/2026 - read only sessions, for replicas (see replication)
+ *  10/19/2026 - watched trees: survey questions, games survive restructures
+ *
+ * notes:
+ * - the prompts are the ones InteractivePlayer shows. Once DONE, prompt() is
+ *   the closing line of the game.
+ * - other sessions may teach the leaf a session is waiting on. The session
+ *   then keeps asking from the new question instead of teaching it again.
+ * - sessions don't lock the tree, every session of a tree must be fed from
+ *   the same thread.
+ * - every session of a tree kept by a depth_watchdog must be given the
+ *   watchdog. After a restructure a session walks the new tree from the root
+ *   with the answers it was given and asks on from the first question it
+ *   wasn't, a guess or lesson in progress goes on if that walk ends at the
+ *   same animal.
+ */
+
+#ifndef GAME_SESSION_HPP
+#define GAME_SESSION_HPP
+
+#include <string>
+#include <vector>
+
+#include "animal_node.hpp"
+#include "animal_tree.hpp"
+#include "depth_watchdog.hpp"
+
+using namespace std;
+
+namespace game_session {
+
+    enum State {
+        ASKING,        // prompt is a question node
+        GUESSING,      // prompt asks to confirm the guessed animal
+        ASK_ANIMAL,    // wrong guess, prompt asks for the player's animal
+        ASK_QUESTION,  // prompt asks for a question telling both animals apart
+        SURVEY,        // right guess, prompt asks the watchdog's question about the animal
+        DONE
+    };
+
+    struct GameSession {
+        // starts a game at the root of tree, a wrong guess ends the game
+        // instead of teaching it if can_learn is false. The game reports to
+        // watchdog (if given) and asks its questions
+        explicit GameSession(animal_tree::AnimalTree& tree, bool can_learn = true,
+                             depth_watchdog::Watchdog* watchdog = nullptr);
+
+        State state() const { return current_state; }
+
+        // what the player has to answer next
+        const string& prompt() const { return pending_prompt; }
+
+        // answers the prompt and moves to the next one
+        void feed(const string& answer);
+
+        // how the game went so far
+        const animal_tree::GameResult& result() const { return game_result; }
+
+    private:
+        struct Answered {
+            string question;
+            bool yes;
+        };
+
+        animal_tree::AnimalTree& tree;
+        bool can_learn;
+        depth_watchdog::Watchdog* watchdog;
+        animal_node::AnimalNode* node;  // question asked or animal guessed
+        State current_state;
+        string pending_prompt;
+        string animal;                  // player's animal while ASK_QUESTION
+        string guess;                   // animal guessed
+        string survey_question;         // asked while SURVEY
+        vector<Answered> answered;      // only kept for a watched tree
+        size_t restructures;            // of the tree when node was reached
+        animal_tree::GameResult game_result;
+
+        void enter(animal_node::AnimalNode* next);
+        void finish(const string& closing);
+        bool catch_up(const string& answer);
+    };
+
+}  // namespace game_session
+
+#endif  // GAME_SESSION_HPP
@@ -0,0 +1,204 @@
+/*
+ * ID3 Tree Builder Implementation
+ * file: id3_builder.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to build a tree from an attribute matrix
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - built trees are hashed
+ *
+ * notes:
+ * - the tree is grown one level at a time. Every animal remembers which open
+ *   node of the level it's in, so evaluating a question for all the open nodes
+ *   of a level is a single scan of the question's bitset: every set bit adds
+ *   one to the yes count of the animal's node. The questions are split
+ *   between the threads, each one keeps its own best question per node.
+ */
+
+#include "id3_builder.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace animal_node;
+
+namespace id3_builder {
+
+    const uint32_t NONE = UINT32_MAX;
+
+    // node of the level being grown
+    struct Open {
+        AnimalNode** slot;  // where the node is stored once built
+        size_t count;       // animals that reach it
+        size_t sample;      // one of those animals
+    };
+
+    // best question found for every open node
+    struct Best {
+        vector<size_t> score;  // |2 * yes - count|, lower is better
+        vector<size_t> question;
+
+        explicit Best(size_t nodes) : score(nodes, SIZE_MAX), question(nodes, SIZE_MAX) {}
+
+        void offer(size_t node, size_t candidate_score, size_t candidate) {
+            if (candidate_score < score[node] ||
+                (candidate_score == score[node] && candidate < question[node])) {
+                score[node] = candidate_score;
+                question[node] = candidate;
+            }
+        }
+    };
+
+    /**
+     * @brief Evaluates the questions [first, last) for every open node.
+     *
+     * @param matrix The attribute matrix.
+     * @param node_of Open node of every animal, NONE if its leaf is done.
+     * @param open The open nodes of the level.
+     * @param first First question to be evaluated.
+     * @param last One past the last question to be evaluated.
+     * @param best Receives the best question per open node.
+     */
+    static void evaluate(const attribute_matrix::AttributeMatrix& matrix,
+                         const vector<uint32_t>& node_of, const vector<Open>& open, size_t first,
+                         size_t last, Best& best) {
+        vector<uint32_t> yes(open.size());
+        for (size_t q = first; q < last; q++) {
+            fill(yes.begin(), yes.end(), 0);
+            const vector<uint64_t>& column = matrix.columns[q];
+            for (size_t w = 0; w < matrix.words; w++) {
+                uint64_t bits = column[w];
+                while (bits) {
+                    uint32_t node = node_of[w * 64 + __builtin_ctzll(bits)];
+                    if (node != NONE) {
+                        yes[node]++;
+                    }
+                    bits &= bits - 1;
+                }
+            }
+            for (size_t node = 0; node < open.size(); node++) {
+                size_t count = open[node].count;
+                if (count < 2 || yes[node] == 0 || yes[node] == count) {
+                    continue;
+                }
+                size_t twice = 2 * static_cast<size_t>(yes[node]);
+                best.offer(node, twice > count ? twice - count : count - twice, q);
+            }
+        }
+    }
+
+    /**
+     * @brief Builds a tree from an attribute matrix, greedily by information gain.
+     *
+     * @param matrix The attribute matrix.
+     * @param threads Threads evaluating candidate questions, 0 for all of them.
+     * @return The tree and how it went.
+     */
+    BuildReport build(const attribute_matrix::AttributeMatrix& matrix, unsigned threads) {
+        auto start = chrono::steady_clock::now();
+        if (threads == 0) {
+            threads = thread::hardware_concurrency() ? thread::hardware_concurrency() : 1;
+        }
+        size_t animals = matrix.animals.size();
+        size_t questions = matrix.questions.size();
+
+        BuildReport report;
+        report.root = nullptr;
+        report.depth = 0;
+        report.leaves = 0;
+        report.dropped = 0;
+
+        vector<uint32_t> node_of(matrix.words * 64, NONE);
+        for (size_t a = 0; a < animals; a++) {
+            node_of[a] = 0;
+        }
+        vector<Open> open;
+        Open root = {&report.root, animals, 0};
+        open.push_back(root);
+
+        while (!open.empty()) {
+            Best best(open.size());
+            bool splittable = false;
+            for (const Open& node : open) {
+                splittable = splittable || node.count > 1;
+            }
+            if (splittable) {
+                vector<Best> partial(threads, Best(open.size()));
+                vector<thread> workers;
+                size_t chunk = (questions + threads - 1) / threads;
+                for (unsigned t = 0; t < threads; t++) {
+                    size_t first = t * chunk;
+                    size_t last = min(questions, first + chunk);
+                    if (first >= last) {
+                        break;
+                    }
+                    workers.push_back(thread(evaluate, cref(matrix), cref(node_of), cref(open),
+                                             first, last, ref(partial[t])));
+                }
+                for (thread& worker : workers) {
+                    worker.join();
+                }
+                for (const Best& found : partial) {
+                    for (size_t node = 0; node < open.size(); node++) {
+                        if (found.question[node] != SIZE_MAX) {
+                            best.offer(node, found.score[node], found.question[node]);
+                        }
+                    }
+                }
+            }
+
+            // turn the open nodes into leaves or questions with two new open nodes
+            vector<Open> next;
+            vector<uint32_t> first_child(open.size(), NONE);
+            for (size_t node = 0; node < open.size(); node++) {
+                const Open& current = open[node];
+                size_t question = best.question[node];
+                if (question == SIZE_MAX) {
+                    *current.slot = alloc_animal(matrix.animals[current.sample]);
+                    report.leaves++;
+                    report.dropped += current.count - 1;
+                    continue;
+                }
+                AnimalNode* built = alloc_animal(matrix.questions[question]);
+                *current.slot = built;
+                first_child[node] = static_cast<uint32_t>(next.size());
+                Open yes = {&built->yes_branch, 0, 0};
+                Open no = {&built->no_branch, 0, 0};
+                next.push_back(yes);
+                next.push_back(no);
+            }
+            if (!next.empty()) {
+                report.depth++;
+            }
+
+            for (size_t a = 0; a < animals; a++) {
+                uint32_t node = node_of[a];
+                if (node == NONE) {
+                    continue;
+                }
+                if (first_child[node] == NONE) {
+                    node_of[a] = NONE;
+                    continue;
+                }
+                uint32_t child = first_child[node] + (matrix.answer(a, best.question[node]) ? 0 : 1);
+                node_of[a] = child;
+                if (next[child].count++ == 0) {
+                    next[child].sample = a;
+                }
+            }
+            open.swap(next);
+        }
+        rehash_tree(report.root);
+
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return report;
+    }
+
+}  // namespace id3_builder
@@ -0,0 +1,50 @@
+/*
+ * ID3 Tree Builder
+ * file: id3_builder.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * builds a whole AnimalTree at once from an attribute matrix, picking at
+ * every node the question with the highest information gain (ID3)
+ *
+ * changelog:
+ *  10/19/2026 - initial design, level by level construction
+ *
+ * notes:
+ * - every animal of the matrix is its own class, so the information gain of
+ *   a split of n animals into k and n - k only depends on how even it is:
+ *   log2(n) - (k log2(k) + (n - k) log2(n - k)) / n peaks at k = n / 2.
+ *   The builder compares |2k - n| instead of evaluating logarithms.
+ * - animals whose answers are identical to each other can't be told apart,
+ *   only the first of them gets a leaf and the rest are counted as dropped.
+ */
+
+#ifndef ID3_BUILDER_HPP
+#define ID3_BUILDER_HPP
+
+#include <cstddef>
+
+#include "animal_node.hpp"
+#include "attribute_matrix.hpp"
+
+namespace id3_builder {
+
+    struct BuildReport {
+        animal_node::AnimalNode* root;
+        size_t depth;     // questions on the longest path
+        size_t leaves;
+        size_t dropped;   // animals indistinguishable from another one
+        double seconds;
+    };
+
+    /*
+     *  builds the tree over every animal of matrix, evaluating the candidate
+     *  questions on threads (hardware threads if 0)
+     */
+    BuildReport build(const attribute_matrix::AttributeMatrix& matrix, unsigned threads = 0);
+
+}  // namespace id3_builder
+
+#endif  // ID3_BUILDER_HPP
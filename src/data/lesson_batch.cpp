@@ -0,0 +1,246 @@
+/*
+ * Lesson Batch Implementation
+ * file: lesson_batch.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to read and apply lesson files
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - single line parsing and formatting, shared with replication
+ *  10/19/2026 - the paths of a batch are rehashed once, after the flips
+ */
+
+#include "lesson_batch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "output.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace lesson_batch {
+
+    // lessons a thread gets at least, fewer aren't worth starting it
+    const size_t MIN_CHUNK = 4096;
+
+    /**
+     * @brief Parses one lesson line, see lesson_batch.hpp for the format.
+     *
+     * @return False if the line is malformed, lesson is then left undefined.
+     */
+    bool parse_line(const string& line, Lesson& lesson) {
+        size_t first_tab = line.find('\t');
+        size_t second_tab = first_tab == string::npos ? first_tab : line.find('\t', first_tab + 1);
+        if (second_tab == string::npos) {
+            return false;
+        }
+        lesson.path = line.substr(0, first_tab);
+        lesson.animal = line.substr(first_tab + 1, second_tab - first_tab - 1);
+        lesson.question = line.substr(second_tab + 1);
+        if (lesson.path == "-") {
+            lesson.path.clear();
+        }
+        return lesson.path.find_first_not_of("yn") == string::npos && !lesson.animal.empty() &&
+               !lesson.question.empty();
+    }
+
+    string format_line(const Lesson& lesson) {
+        return (lesson.path.empty() ? "-" : lesson.path) + '\t' + lesson.animal + '\t' +
+               lesson.question;
+    }
+
+    /**
+     * @brief Parses a lesson file.
+     *
+     * @param input_stream The lesson file.
+     * @param lessons Where the lessons are appended.
+     * @return False if a line is malformed.
+     */
+    bool load(istream& input_stream, vector<Lesson>& lessons) {
+        string line;
+        size_t line_number = 0;
+        while (getline(input_stream, line)) {
+            line_number++;
+            if (!line.empty() && line[line.size() - 1] == '\r') {
+                line.erase(line.size() - 1);
+            }
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            Lesson lesson;
+            if (!parse_line(line, lesson)) {
+                output::error("malformed lesson line " + to_string(line_number) +
+                              ", expected path, animal and question separated by tabs");
+                return false;
+            }
+            lesson.line = line_number;
+            lessons.push_back(lesson);
+        }
+        return true;
+    }
+
+    bool load_file(const string& path, vector<Lesson>& lessons) {
+        ifstream input_file(path.c_str());
+        if (!input_file) {
+            output::error("could not open " + path);
+            return false;
+        }
+        return load(input_file, lessons);
+    }
+
+    // runs work(first, last) over [0, count) split between threads
+    template <typename Work>
+    static void in_parallel(size_t count, unsigned threads, Work work) {
+        size_t useful = max<size_t>(1, count / MIN_CHUNK);
+        if (threads > useful) {
+            threads = static_cast<unsigned>(useful);
+        }
+        if (threads <= 1) {
+            work(0, count);
+            return;
+        }
+        vector<thread> workers;
+        size_t chunk = (count + threads - 1) / threads;
+        for (unsigned t = 0; t < threads; t++) {
+            size_t first = t * chunk;
+            size_t last = min(count, first + chunk);
+            if (first < last) {
+                workers.push_back(thread(work, first, last));
+            }
+        }
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Rehashes every node on the given paths once, deepest first.
+     *
+     * The paths are sorted, so the questions a path shares with others are
+     * the ones it shares with the path right before it and only the rest of
+     * the path is walked.
+     *
+     * @param root The root of the tree.
+     * @param paths Sorted paths, each one leading to a node.
+     */
+    static void rehash_paths(AnimalNode* root, const vector<const string*>& paths) {
+        vector<vector<AnimalNode*>> by_depth;
+        vector<AnimalNode*> chain;  // nodes of the previous path
+        const string* previous = nullptr;
+        for (const string* path : paths) {
+            size_t shared = 0;
+            if (previous) {
+                while (shared < previous->size() && shared < path->size() &&
+                       (*previous)[shared] == (*path)[shared]) {
+                    shared++;
+                }
+                chain.resize(shared + 1);
+            } else {
+                chain.assign(1, root);
+                by_depth.assign(1, chain);
+            }
+            for (size_t depth = shared; depth < path->size(); depth++) {
+                AnimalNode* node = chain.back();
+                chain.push_back((*path)[depth] == 'y' ? node->yes_branch : node->no_branch);
+                if (by_depth.size() <= depth + 1) {
+                    by_depth.resize(depth + 2);
+                }
+                by_depth[depth + 1].push_back(chain.back());
+            }
+            previous = path;
+        }
+        for (size_t depth = by_depth.size(); depth > 0; depth--) {
+            for (AnimalNode* node : by_depth[depth - 1]) {
+                node->hash = hash_node(*node);
+            }
+        }
+    }
+
+    /**
+     * @brief Applies a batch of lessons.
+     *
+     * First every path is followed (reading the tree only), then the lessons
+     * are checked for conflicts in path order, and then the animals are
+     * flipped. Both the first and the last step run on threads: the first
+     * doesn't write and the last writes a different animal per lesson. The
+     * hashes above the flipped animals are shared between lessons, so they are
+     * brought up to date afterwards, once per node.
+     *
+     * @param tree The tree to be taught.
+     * @param lessons The lessons, in file order.
+     * @param threads Threads applying lessons, 0 for all of them.
+     * @return What was applied and what wasn't.
+     */
+    BatchReport apply(animal_tree::AnimalTree& tree, const vector<Lesson>& lessons,
+                      unsigned threads) {
+        auto start = chrono::steady_clock::now();
+        if (threads == 0) {
+            threads = thread::hardware_concurrency() ? thread::hardware_concurrency() : 1;
+        }
+        BatchReport report;
+        report.applied = 0;
+
+        vector<size_t> order(lessons.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        stable_sort(order.begin(), order.end(), [&lessons](size_t a, size_t b) {
+            return lessons[a].path < lessons[b].path;
+        });
+
+        vector<AnimalNode*> leaf_of(order.size());
+        in_parallel(order.size(), threads, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                leaf_of[i] = tree.leaf_at(lessons[order[i]].path);
+            }
+        });
+
+        vector<size_t> work;  // positions in order to apply
+        for (size_t i = 0; i < order.size(); i++) {
+            if (!leaf_of[i]) {
+                report.unreachable.push_back(order[i]);
+            } else if (!work.empty() && leaf_of[work.back()] == leaf_of[i]) {
+                Conflict conflict = {order[i], order[work.back()]};
+                report.conflicts.push_back(conflict);
+            } else {
+                work.push_back(i);
+            }
+        }
+        sort(report.unreachable.begin(), report.unreachable.end());
+
+        animal_tree::TreeObserver* observer = tree.observer;
+        bool hash_flips = tree.hash_flips;
+        tree.observer = nullptr;
+        tree.hash_flips = false;
+        in_parallel(work.size(), threads, [&](size_t first, size_t last) {
+            for (size_t w = first; w < last; w++) {
+                const Lesson& lesson = lessons[order[work[w]]];
+                tree.learn(leaf_of[work[w]], lesson.path, lesson.question, lesson.animal);
+            }
+        });
+        tree.observer = observer;
+        tree.hash_flips = hash_flips;
+
+        vector<const string*> applied_paths;
+        for (size_t i : work) {
+            applied_paths.push_back(&lessons[order[i]].path);
+        }
+        rehash_paths(tree.root, applied_paths);
+        if (observer) {
+            for (size_t i : work) {
+                observer->on_flip(leaf_of[i], lessons[order[i]].path);
+            }
+        }
+
+        report.applied = work.size();
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return report;
+    }
+
+}  // namespace lesson_batch
@@ -0,0 +1,84 @@
+/*
+ * Lesson Batch
+ * file: lesson_batch.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * teaches the tree many lessons at once, read from a file instead of asked
+ * at the end of every game
+ *
+ * A lesson file has one lesson per line: the path of the wrong guess ('y' or
+ * 'n' per question answered, "-" for the root), the animal and the question
+ * that is yes for it and no for the guess, separated by tabs. Empty lines and
+ * lines starting with '#' are ignored.
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *  10/19/2026 - single line parsing and formatting
+ *
+ * notes:
+ * - every path is followed in the tree as it was before the batch, a lesson
+ *   never lands on an animal another lesson of the same batch created.
+ * - lessons are sorted by path, lessons for the same animal end up next to
+ *   each other: the first one in the file is applied, the rest are conflicts.
+ * - what is left touches a different animal per lesson, so the lessons are
+ *   split between threads and applied at the same time. The tree's observer
+ *   is told about them afterwards, in path order, from the calling thread.
+ */
+
+#ifndef LESSON_BATCH_HPP
+#define LESSON_BATCH_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace lesson_batch {
+
+    const size_t NONE = SIZE_MAX;
+
+    struct Lesson {
+        string path;
+        string animal;
+        string question;
+        size_t line;  // in the lesson file, 0 if not read from one
+    };
+
+    struct Conflict {
+        size_t lesson;   // rejected lesson
+        size_t applied;  // lesson applied to the same animal
+    };
+
+    struct BatchReport {
+        size_t applied;
+        vector<Conflict> conflicts;
+        vector<size_t> unreachable;  // lessons whose path doesn't end at an animal
+        double seconds;
+    };
+
+    // one line of a lesson file, parse_line returns false if it is malformed
+    bool parse_line(const string& line, Lesson& lesson);
+    string format_line(const Lesson& lesson);
+
+    // parses a lesson file, returns false (after reporting why) if it is malformed
+    bool load(istream& input_stream, vector<Lesson>& lessons);
+
+    bool load_file(const string& path, vector<Lesson>& lessons);
+
+    /*
+     *  applies lessons to tree on threads (hardware threads if 0), indices in
+     *  the report refer to lessons
+     */
+    BatchReport apply(animal_tree::AnimalTree& tree, const vector<Lesson>& lessons,
+                      unsigned threads = 0);
+
+}  // namespace lesson_batch
+
+#endif  // LESSON_BATCH_HPP
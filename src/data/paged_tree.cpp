@@ -0,0 +1,399 @@
+/*
+ * Paged Tree Implementation
+ * file: paged_tree.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to split trees into pages and play on them
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - flips on a page skip rehashing
+ *
+ * notes:
+ * - the link to another page is an empty animal node of the parent page,
+ *   remembered in Page::links. A game reaching it continues at the root of
+ *   the linked page.
+ * - visits are not counted on paged games, pages don't store them and
+ *   counting would make every page on a path dirty.
+ */
+
+#include "paged_tree.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <unordered_set>
+
+#include "metrics.hpp"
+#include "output.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace paged_tree {
+
+    const int64_t NO_LINK = -1;
+
+    /**
+     * @brief Writes a page, replacing the file at path atomically.
+     *
+     * @param path The page file.
+     * @param root Root of the page.
+     * @param link_of Page linked from a node, NO_LINK for nodes of the page.
+     * @return True if the page was fully written.
+     */
+    template <typename LinkOf>
+    static bool write_page(const string& path, const AnimalNode* root, LinkOf link_of) {
+        string tmp_path = path + ".tmp";
+        {
+            ofstream output_file(tmp_path.c_str());
+            vector<const AnimalNode*> pending;
+            pending.push_back(root);
+            while (!pending.empty()) {
+                const AnimalNode* node = pending.back();
+                pending.pop_back();
+                int64_t link = link_of(node);
+                if (link != NO_LINK) {
+                    output_file << "L " << link << '\n';
+                } else if (node->is_question()) {
+                    output_file << "Q " << node->str << '\n';
+                    pending.push_back(node->no_branch);
+                    pending.push_back(node->yes_branch);
+                } else {
+                    output_file << "G " << node->str << '\n';
+                }
+            }
+            output_file.flush();
+            if (!output_file) {
+                output::error("could not write " + tmp_path);
+                remove(tmp_path.c_str());
+                return false;
+            }
+        }
+        int fd = open(tmp_path.c_str(), O_RDONLY);
+        bool synced = fd >= 0 && fsync(fd) == 0;
+        if (fd >= 0) {
+            close(fd);
+        }
+        if (!synced || rename(tmp_path.c_str(), path.c_str()) != 0) {
+            output::error("could not replace " + path);
+            remove(tmp_path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    static string page_path(const string& directory, uint32_t id) {
+        return directory + "/" + to_string(id) + ".page";
+    }
+
+    /**
+     * @brief Counts the nodes of every subtree, without recursion.
+     *
+     * @param root The tree.
+     * @param sizes Receives the size of the subtree of every node.
+     */
+    static void subtree_sizes(const AnimalNode* root,
+                              unordered_map<const AnimalNode*, size_t>& sizes) {
+        vector<const AnimalNode*> preorder;
+        vector<const AnimalNode*> pending(1, root);
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back();
+            pending.pop_back();
+            preorder.push_back(node);
+            if (node->is_question()) {
+                pending.push_back(node->no_branch);
+                pending.push_back(node->yes_branch);
+            }
+        }
+        sizes.reserve(preorder.size());
+        for (size_t i = preorder.size(); i > 0; i--) {
+            const AnimalNode* node = preorder[i - 1];
+            size_t size = 1;
+            if (node->is_question()) {
+                size += sizes[node->yes_branch] + sizes[node->no_branch];
+            }
+            sizes[node] = size;
+        }
+    }
+
+    /**
+     * @brief Splits a tree into pages.
+     *
+     * Half of a page is filled breadth first from its root. The subtrees
+     * hanging from that top part are then taken whole, smallest first, while
+     * they fit in the other half, so small subtrees don't end up as pages of
+     * a handful of nodes. The subtrees left become pages of their own.
+     *
+     * @param root The tree to be split.
+     * @param directory Where the pages are written.
+     * @param page_nodes Nodes per page.
+     * @return Number of pages written, 0 if the pages couldn't be written.
+     */
+    size_t split(const AnimalNode* root, const string& directory, size_t page_nodes) {
+        if (!root || page_nodes == 0) {
+            return 0;
+        }
+        if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+            output::error("could not create " + directory);
+            return 0;
+        }
+        unordered_map<const AnimalNode*, size_t> sizes;
+        subtree_sizes(root, sizes);
+
+        vector<const AnimalNode*> page_roots(1, root);
+        for (size_t id = 0; id < page_roots.size(); id++) {
+            unordered_set<const AnimalNode*> in_page;
+            vector<const AnimalNode*> hanging;
+            size_t top_nodes = max<size_t>(1, page_nodes / 2);
+            deque<const AnimalNode*> frontier(1, page_roots[id]);
+            while (!frontier.empty()) {
+                const AnimalNode* node = frontier.front();
+                frontier.pop_front();
+                if (in_page.size() >= top_nodes) {
+                    hanging.push_back(node);
+                    continue;
+                }
+                in_page.insert(node);
+                if (node->is_question()) {
+                    frontier.push_back(node->yes_branch);
+                    frontier.push_back(node->no_branch);
+                }
+            }
+
+            // whole subtrees, smallest first
+            sort(hanging.begin(), hanging.end(),
+                 [&](const AnimalNode* a, const AnimalNode* b) { return sizes[a] < sizes[b]; });
+            size_t used = in_page.size();
+            for (const AnimalNode* subtree : hanging) {
+                if (used + sizes[subtree] > page_nodes) {
+                    break;
+                }
+                used += sizes[subtree];
+                vector<const AnimalNode*> pending(1, subtree);
+                while (!pending.empty()) {
+                    const AnimalNode* node = pending.back();
+                    pending.pop_back();
+                    in_page.insert(node);
+                    if (node->is_question()) {
+                        pending.push_back(node->no_branch);
+                        pending.push_back(node->yes_branch);
+                    }
+                }
+            }
+
+            bool written = write_page(page_path(directory, id), page_roots[id],
+                                      [&](const AnimalNode* node) -> int64_t {
+                                          if (in_page.count(node)) {
+                                              return NO_LINK;
+                                          }
+                                          page_roots.push_back(node);
+                                          return static_cast<int64_t>(page_roots.size() - 1);
+                                      });
+            if (!written) {
+                return 0;
+            }
+        }
+        return page_roots.size();
+    }
+
+    PagedTree::PagedTree(const string& directory, size_t cache_pages)
+        : directory(directory), capacity(cache_pages ? cache_pages : 1) {
+        counters.resident = 0;
+        counters.faults = 0;
+        counters.evictions = 0;
+        counters.writebacks = 0;
+    }
+
+    PagedTree::~PagedTree() {
+        flush();
+        for (auto& item : pages) {
+            free_tree(item.second.root);
+        }
+    }
+
+    bool PagedTree::valid() const {
+        return ifstream(path_of(0).c_str()).good();
+    }
+
+    string PagedTree::path_of(uint32_t id) const {
+        return page_path(directory, id);
+    }
+
+    /**
+     * @brief Returns page id, loading it if it isn't resident.
+     *
+     * @param id The page.
+     * @return The page, nullptr if it can't be read.
+     */
+    PagedTree::Page* PagedTree::fault(uint32_t id) {
+        unordered_map<uint32_t, Page>::iterator found = pages.find(id);
+        if (found != pages.end()) {
+            lru.splice(lru.begin(), lru, found->second.used);
+            return &found->second;
+        }
+
+        metrics::Timer timer(metrics::PAGE_FAULT_LATENCY);
+        ifstream input_file(path_of(id).c_str());
+        if (!input_file) {
+            output::error("missing page " + path_of(id));
+            return nullptr;
+        }
+        Page page;
+        page.root = nullptr;
+        page.dirty = false;
+        page.pinned = false;
+        vector<AnimalNode**> slots(1, &page.root);
+        string line;
+        while (!slots.empty() && getline(input_file, line)) {
+            if (line.size() < 2 || (line[0] != 'Q' && line[0] != 'G' && line[0] != 'L')) {
+                continue;
+            }
+            AnimalNode** slot = slots.back();
+            slots.pop_back();
+            if (line[0] == 'L') {
+                *slot = alloc_animal("");
+                page.links[*slot] = static_cast<uint32_t>(strtoul(line.c_str() + 2, nullptr, 10));
+                continue;
+            }
+            *slot = alloc_animal(line.substr(2));
+            if (line[0] == 'Q') {
+                slots.push_back(&(*slot)->no_branch);
+                slots.push_back(&(*slot)->yes_branch);
+            }
+        }
+        if (!slots.empty()) {
+            output::error("page " + path_of(id) + " is incomplete");
+            free_tree(page.root);
+            return nullptr;
+        }
+
+        evict_if_needed(capacity - 1);
+        lru.push_front(id);
+        page.used = lru.begin();
+        counters.faults++;
+        return &(pages[id] = page);
+    }
+
+    /**
+     * @brief Drops least recently used pages off the cache, writing back the
+     * dirty ones, until at most keep pages are resident. Pinned pages stay.
+     *
+     * @param keep Pages that may stay resident.
+     */
+    void PagedTree::evict_if_needed(size_t keep) {
+        list<uint32_t>::iterator candidate = lru.end();
+        while (pages.size() > keep && candidate != lru.begin()) {
+            --candidate;
+            Page& page = pages.find(*candidate)->second;
+            if (page.pinned) {
+                continue;
+            }
+            if (page.dirty && !write_back(*candidate, page)) {
+                continue;  // kept, the lesson would be lost
+            }
+            free_tree(page.root);
+            pages.erase(*candidate);
+            candidate = lru.erase(candidate);
+            counters.evictions++;
+        }
+    }
+
+    bool PagedTree::write_back(uint32_t id, Page& page) {
+        bool written = write_page(path_of(id), page.root, [&](const AnimalNode* node) -> int64_t {
+            unordered_map<const AnimalNode*, uint32_t>::const_iterator link = page.links.find(node);
+            return link == page.links.end() ? NO_LINK : static_cast<int64_t>(link->second);
+        });
+        if (written) {
+            page.dirty = false;
+            counters.writebacks++;
+        }
+        return written;
+    }
+
+    bool PagedTree::flush() {
+        bool ok = true;
+        for (auto& item : pages) {
+            if (item.second.dirty) {
+                ok = write_back(item.first, item.second) && ok;
+            }
+        }
+        return ok;
+    }
+
+    PagingStats PagedTree::stats() const {
+        PagingStats current = counters;
+        current.resident = pages.size();
+        return current;
+    }
+
+    /**
+     * @brief Plays a game, faulting in the pages on its path.
+     *
+     * The pages of the path are pinned until the game is over, so the nodes
+     * being walked are never evicted under the game.
+     *
+     * @param player Who answers the questions.
+     * @return How the game went.
+     */
+    animal_tree::GameResult PagedTree::play_game(animal_tree::Player& player) {
+        animal_tree::GameResult result;
+        result.questions = 0;
+        result.guessed = false;
+        result.learned = false;
+
+        vector<Page*> path_pages;
+        Page* page = fault(0);
+        AnimalNode* node = page ? page->root : nullptr;
+        while (page) {
+            if (path_pages.empty() || path_pages.back() != page) {
+                page->pinned = true;
+                path_pages.push_back(page);
+            }
+            unordered_map<const AnimalNode*, uint32_t>::iterator link = page->links.find(node);
+            if (link != page->links.end()) {
+                page = fault(link->second);
+                node = page ? page->root : nullptr;
+                continue;
+            }
+            if (!node->is_question()) {
+                break;
+            }
+            result.questions++;
+            bool yes = player.answer(node->str);
+            result.path += yes ? 'y' : 'n';
+            node = yes ? node->yes_branch : node->no_branch;
+        }
+
+        if (page) {
+            string animal;
+            string question;
+            if (player.confirm_guess(node->str)) {
+                result.guessed = true;
+            } else if (player.teach(node->str, animal, question)) {
+                // result.path starts at the global root, not the page's, and
+                // paged trees keep no hashes, so the flip skips rehashing
+                animal_tree::AnimalTree page_tree(page->root);
+                page_tree.hash_flips = false;
+                page_tree.learn(node, result.path, question, animal);
+                page->dirty = true;
+                result.learned = true;
+            }
+        }
+        for (Page* visited : path_pages) {
+            visited->pinned = false;
+        }
+        evict_if_needed(capacity);
+        return result;
+    }
+
+}  // namespace paged_tree
@@ -0,0 +1,108 @@
+/*
+ * Paged Tree
+ * file: paged_tree.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * plays on knowledge bases too large for memory: the tree is split on disk
+ * into subtree pages and a game only loads the pages on its path, through a
+ * bounded cache of pages
+ *
+ * A paged database is a directory holding <id>.page files, page 0 holds the
+ * root. A page is a tree_io text listing where "L <id>" stands for the
+ * subtree stored in page id.
+ *
+ * changelog:
+ *  10/19/2026 - initial design, LRU page cache with write back
+ *
+ * notes:
+ * - split fills half of every page breadth first from its root, so a page
+ *   holds the top levels of its subtree and a game crosses about
+ *   depth / log2(page_nodes / 2) pages. The other half takes small subtrees
+ *   whole.
+ * - lessons are learned into the page of the guessed leaf, which is marked
+ *   dirty and written back when it is evicted or flushed. Pages grow with
+ *   what they learn, split the tree again to even them out.
+ * - not thread safe, a PagedTree is played by one thread at a time.
+ */
+
+#ifndef PAGED_TREE_HPP
+#define PAGED_TREE_HPP
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "animal_node.hpp"
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace paged_tree {
+
+    const size_t DEFAULT_PAGE_NODES = 4096;
+
+    /*
+     *  writes the subtree to directory (created if needed) as pages of at most
+     *  page_nodes nodes, returns the number of pages, 0 on failure
+     */
+    size_t split(const animal_node::AnimalNode* root, const string& directory,
+                 size_t page_nodes = DEFAULT_PAGE_NODES);
+
+    struct PagingStats {
+        size_t resident;    // pages in memory
+        size_t faults;      // pages loaded
+        size_t evictions;   // pages dropped from memory
+        size_t writebacks;  // dirty pages written
+    };
+
+    struct PagedTree {
+        // serves the pages under directory, keeping at most cache_pages of them
+        PagedTree(const string& directory, size_t cache_pages);
+
+        // writes back the dirty pages
+        ~PagedTree();
+
+        // true if directory holds a paged database
+        bool valid() const;
+
+        // plays a game, loading the pages on its path
+        animal_tree::GameResult play_game(animal_tree::Player& player);
+
+        // writes back the dirty pages, keeping them resident
+        bool flush();
+
+        PagingStats stats() const;
+        const string& path() const { return directory; }
+
+    private:
+        struct Page {
+            animal_node::AnimalNode* root;
+            unordered_map<const animal_node::AnimalNode*, uint32_t> links;  // leaf -> page
+            bool dirty;
+            bool pinned;                   // on the path of the game being played
+            list<uint32_t>::iterator used;  // position in lru
+        };
+
+        string directory;
+        size_t capacity;
+        unordered_map<uint32_t, Page> pages;
+        list<uint32_t> lru;                // most recently used first
+        PagingStats counters;
+
+        PagedTree(const PagedTree&);
+        PagedTree& operator=(const PagedTree&);
+
+        Page* fault(uint32_t id);
+        void evict_if_needed(size_t keep);
+        bool write_back(uint32_t id, Page& page);
+        string path_of(uint32_t id) const;
+    };
+
+}  // namespace paged_tree
+
+#endif  // PAGED_TREE_HPP
@@ -0,0 +1,375 @@
+/*
+ * Shared Tree Implementation
+ * file: shared_tree.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to share a tree through POSIX shared memory
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - create refuses names a live writer published
+ */
+
+#include "shared_tree.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+#include "output.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace shared_tree {
+
+    const char MAGIC[4] = {'A', 'G', 'S', 'M'};
+    const uint32_t VERSION = 2;
+    const uint64_t MAX_CAPACITY = (1ULL << 32) * UNIT;
+
+    static size_t units(size_t bytes) {
+        return (bytes + UNIT - 1) / UNIT;
+    }
+
+    // links change under readers, they are always read and written atomically
+    static uint32_t load_link(const uint32_t& link) {
+        return __atomic_load_n(&link, __ATOMIC_ACQUIRE);
+    }
+
+    static void store_link(uint32_t& link, uint32_t offset) {
+        __atomic_store_n(&link, offset, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * @brief Tells whether the segment name was left by a writer that is gone.
+     *
+     * A segment without a writer yet may still be being created, so it is
+     * never stale.
+     */
+    static bool is_stale(const string& name) {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            return errno == ENOENT;  // removed meanwhile, the name is free
+        }
+        struct stat status;
+        uint32_t writer = 0;
+        if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= sizeof(Header)) {
+            void* memory = mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0);
+            if (memory != MAP_FAILED) {
+                writer = __atomic_load_n(&static_cast<const Header*>(memory)->writer,
+                                         __ATOMIC_ACQUIRE);
+                munmap(memory, sizeof(Header));
+            }
+        }
+        close(fd);
+        return writer != 0 && kill(static_cast<pid_t>(writer), 0) != 0 && errno == ESRCH;
+    }
+
+    SharedTree::SharedTree() : base(nullptr), header(nullptr), mapped(0), writer(false) {}
+
+    SharedTree::~SharedTree() {
+        release();
+    }
+
+    void SharedTree::release() {
+        if (base) {
+            munmap(base, mapped);
+        }
+        if (writer) {
+            shm_unlink(segment_name.c_str());
+        }
+        base = nullptr;
+        header = nullptr;
+        mapped = 0;
+        writer = false;
+        texts.clear();
+    }
+
+    const Node& SharedTree::node_at(uint32_t offset) const {
+        return *reinterpret_cast<const Node*>(base + static_cast<size_t>(offset) * UNIT);
+    }
+
+    string SharedTree::text_of(const Node& node) const {
+        return string(base + static_cast<size_t>(node.text) * UNIT, node.length);
+    }
+
+    /**
+     * @brief Takes bytes from the free end of the segment, writer only.
+     *
+     * @return The offset of the space, 0 if the segment is full.
+     */
+    uint32_t SharedTree::allocate(size_t bytes) {
+        size_t size = units(bytes) * UNIT;
+        if (header->used + size > header->capacity) {
+            return 0;
+        }
+        uint32_t offset = static_cast<uint32_t>(header->used / UNIT);
+        __atomic_store_n(&header->used, header->used + size, __ATOMIC_RELAXED);
+        return offset;
+    }
+
+    // offset of text in the pool, added if new, 0 if the segment is full
+    uint32_t SharedTree::add_text(const string& text) {
+        unordered_map<string, uint32_t>::iterator pooled = texts.find(text);
+        if (pooled != texts.end()) {
+            return pooled->second;
+        }
+        uint32_t offset = allocate(text.empty() ? 1 : text.size());
+        if (offset) {
+            memcpy(base + static_cast<size_t>(offset) * UNIT, text.data(), text.size());
+            texts[text] = offset;
+        }
+        return offset;
+    }
+
+    uint32_t SharedTree::add_node(uint32_t yes, uint32_t no, uint32_t text, uint32_t length) {
+        uint32_t offset = allocate(sizeof(Node));
+        if (offset) {
+            Node* node = reinterpret_cast<Node*>(base + static_cast<size_t>(offset) * UNIT);
+            node->yes = yes;
+            node->no = no;
+            node->text = text;
+            node->length = length;
+        }
+        return offset;
+    }
+
+    /**
+     * @brief Creates the segment and copies the tree into it.
+     *
+     * A stale segment left under name by a writer that died is replaced, a
+     * segment of a live writer is left alone and create fails. The segment is sized for every node and text (before pooling) plus
+     * spare_bytes, pages of it that are never written take no memory.
+     *
+     * @param name The segment's name, starting with '/'.
+     * @param root The tree to be shared.
+     * @param spare_bytes Room left for learning.
+     * @return False (after reporting why) if the segment can't be set up.
+     */
+    bool SharedTree::create(const string& name, const AnimalNode* root, size_t spare_bytes) {
+        release();
+        if (!root) {
+            output::error("the tree is empty");
+            return false;
+        }
+        size_t needed = units(sizeof(Header)) * UNIT;
+        size_t node_count = 0;
+        vector<const AnimalNode*> pending(1, root);
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back();
+            pending.pop_back();
+            node_count++;
+            needed += units(sizeof(Node)) * UNIT + units(node->str.size() + 1) * UNIT;
+            if (node->is_question()) {
+                pending.push_back(node->no_branch);
+                pending.push_back(node->yes_branch);
+            }
+        }
+        long page = sysconf(_SC_PAGESIZE);
+        size_t capacity = (needed + spare_bytes + page - 1) / page * page;
+        if (capacity > MAX_CAPACITY) {
+            output::error("the tree is too large for a shared segment");
+            return false;
+        }
+
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0 && errno == EEXIST && is_stale(name)) {
+            output::inform("replacing " + name + ", its writer is gone");
+            shm_unlink(name.c_str());
+            fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        }
+        if (fd < 0 && errno == EEXIST) {
+            output::error(name + " is already published by another process");
+            return false;
+        }
+        if (fd < 0) {
+            output::error("could not create " + name + ": " + strerror(errno));
+            return false;
+        }
+        if (ftruncate(fd, static_cast<off_t>(capacity)) != 0) {
+            output::error("could not size " + name + ": " + strerror(errno));
+            close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+        void* memory = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED) {
+            output::error("could not map " + name + ": " + strerror(errno));
+            shm_unlink(name.c_str());
+            return false;
+        }
+        base = static_cast<char*>(memory);
+        mapped = capacity;
+        writer = true;
+        segment_name = name;
+        header = reinterpret_cast<Header*>(base);
+        header->version = VERSION;
+        header->capacity = capacity;
+        header->used = units(sizeof(Header)) * UNIT;
+        header->nodes = node_count;
+        header->flips = 0;
+        __atomic_store_n(&header->writer, static_cast<uint32_t>(getpid()), __ATOMIC_RELEASE);
+
+        // preorder, each node is linked into the slot its parent left for it
+        vector<pair<const AnimalNode*, uint32_t*> > slots;
+        slots.push_back(make_pair(root, &header->root));
+        while (!slots.empty()) {
+            const AnimalNode* source = slots.back().first;
+            uint32_t* slot = slots.back().second;
+            slots.pop_back();
+            uint32_t offset = add_node(0, 0, add_text(source->str),
+                                       static_cast<uint32_t>(source->str.size()));
+            *slot = offset;
+            if (source->is_question()) {
+                Node* node = reinterpret_cast<Node*>(base + static_cast<size_t>(offset) * UNIT);
+                slots.push_back(make_pair(source->no_branch, &node->no));
+                slots.push_back(make_pair(source->yes_branch, &node->yes));
+            }
+        }
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy(header->magic, MAGIC, sizeof(MAGIC));
+        return true;
+    }
+
+    /**
+     * @brief Maps a segment created by another process, read only.
+     *
+     * @param name The segment's name.
+     * @return False (after reporting why) if it isn't a shared tree.
+     */
+    bool SharedTree::attach(const string& name) {
+        release();
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            output::error("could not open " + name + ": " + strerror(errno));
+            return false;
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(Header)) {
+            output::error(name + " is not a shared tree");
+            close(fd);
+            return false;
+        }
+        size_t size = static_cast<size_t>(status.st_size);
+        void* memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED) {
+            output::error("could not map " + name + ": " + strerror(errno));
+            return false;
+        }
+        const Header* mapped_header = static_cast<const Header*>(memory);
+        if (memcmp(mapped_header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            mapped_header->version != VERSION || mapped_header->capacity != size) {
+            output::error(name + " is not a shared tree");
+            munmap(memory, size);
+            return false;
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        base = static_cast<char*>(memory);
+        header = reinterpret_cast<Header*>(base);
+        mapped = size;
+        segment_name = name;
+        return true;
+    }
+
+    /**
+     * @brief Plays a game on the segment, straight from shared memory.
+     *
+     * @param player Who answers the questions.
+     * @return How the game went.
+     */
+    animal_tree::GameResult SharedTree::play_game(animal_tree::Player& player) {
+        animal_tree::GameResult result;
+        result.questions = 0;
+        result.guessed = false;
+        result.learned = false;
+        if (!header) {
+            output::error("no shared tree is attached");
+            return result;
+        }
+
+        const Node* node = &node_at(load_link(header->root));
+        while (load_link(node->yes)) {
+            result.questions++;
+            bool yes = player.answer(text_of(*node));
+            result.path += yes ? 'y' : 'n';
+            node = &node_at(load_link(yes ? node->yes : node->no));
+        }
+
+        string guessed = text_of(*node);
+        string animal;
+        string question;
+        if (player.confirm_guess(guessed)) {
+            result.guessed = true;
+        } else if (writer && player.teach(guessed, animal, question)) {
+            result.learned = learn(result.path, question, animal);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Flips the animal at path into question, see the notes of the
+     * header for why readers never see it half done.
+     *
+     * @param path 'y' or 'n' per question from the root.
+     * @param question Yes for animal, no for the old guess.
+     * @param animal The new animal.
+     * @return False if this isn't the writer, path doesn't end at an animal
+     * or the segment is full.
+     */
+    bool SharedTree::learn(const string& path, const string& question, const string& animal) {
+        if (!writer) {
+            output::error("only the process that created " + segment_name + " can teach it");
+            return false;
+        }
+        uint32_t* link = &header->root;
+        for (char answer : path) {
+            Node* node = reinterpret_cast<Node*>(base + static_cast<size_t>(*link) * UNIT);
+            if (!node->yes || (answer != 'y' && answer != 'n')) {
+                return false;
+            }
+            link = answer == 'y' ? &node->yes : &node->no;
+        }
+        const Node& leaf = node_at(*link);
+        if (leaf.yes) {
+            return false;
+        }
+
+        size_t worst = 3 * units(sizeof(Node)) * UNIT + units(question.size() + 1) * UNIT +
+                       units(animal.size() + 1) * UNIT;
+        if (header->used + worst > header->capacity) {
+            output::error(segment_name + " is full");
+            return false;
+        }
+        uint32_t yes = add_node(0, 0, add_text(animal), static_cast<uint32_t>(animal.size()));
+        uint32_t no = add_node(0, 0, leaf.text, leaf.length);
+        uint32_t flipped = add_node(yes, no, add_text(question),
+                                    static_cast<uint32_t>(question.size()));
+        store_link(*link, flipped);
+        __atomic_fetch_add(&header->nodes, 2, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&header->flips, 1, __ATOMIC_RELAXED);
+        return true;
+    }
+
+    size_t SharedTree::nodes() const {
+        return header ? __atomic_load_n(&header->nodes, __ATOMIC_RELAXED) : 0;
+    }
+
+    size_t SharedTree::used() const {
+        return header ? __atomic_load_n(&header->used, __ATOMIC_RELAXED) : 0;
+    }
+
+    size_t SharedTree::capacity() const {
+        return header ? header->capacity : 0;
+    }
+
+}  // namespace shared_tree
@@ -0,0 +1,120 @@
+/*
+ * Shared Tree
+ * file: shared_tree.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * keeps one copy of the tree in a POSIX shared memory segment that any
+ * number of local processes map and play on, instead of a private copy each
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *  10/19/2026 - the writer's pid is kept, only stale segments are replaced
+ *
+ * notes:
+ * - the segment is a header followed by nodes and texts. Links are offsets
+ *   from the start of the segment in UNIT bytes (0 is no link), so they mean
+ *   the same in every process whatever address it mapped the segment at, and
+ *   a segment can be up to 2^32 units (32 GB).
+ * - texts are pooled: the writer stores every distinct text once, a flip
+ *   reuses the text of the old guess.
+ * - one process creates the segment and is its only writer. A name is only
+ *   taken over from a writer that is gone, never from a live one. Readers map it
+ *   read only. A flip never changes a node readers can reach: the question
+ *   and its two animals are written to unused space and then linked in place
+ *   of the old leaf with a single atomic store, so a reader sees the tree
+ *   either before or after the flip and never needs a lock. The old leaf is
+ *   not reused.
+ * - the segment doesn't grow, it is created with room for the tree plus the
+ *   bytes asked for. learn fails once it is full.
+ */
+
+#ifndef SHARED_TREE_HPP
+#define SHARED_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "animal_node.hpp"
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace shared_tree {
+
+    const size_t UNIT = 8;
+
+    struct Header {
+        char magic[4];       // "AGSM", written last by create
+        uint32_t version;
+        uint64_t capacity;   // bytes of the segment
+        uint64_t used;       // bytes allocated, only the writer changes it
+        uint64_t nodes;      // reachable nodes
+        uint64_t flips;
+        uint32_t root;       // offset of the root node
+        uint32_t writer;     // pid of the process that created the segment
+    };
+
+    struct Node {
+        uint32_t yes;        // offsets of the branches, 0 for animals
+        uint32_t no;
+        uint32_t text;       // offset of the text
+        uint32_t length;     // bytes of the text
+    };
+
+    struct SharedTree {
+        SharedTree();
+
+        // unmaps the segment, the writer also removes its name
+        ~SharedTree();
+
+        /*
+         *  creates the segment name (e.g. "/animal_tree") holding a copy of
+         *  root and spare_bytes of room to learn, this process is its writer
+         */
+        bool create(const string& name, const animal_node::AnimalNode* root, size_t spare_bytes);
+
+        // maps the segment name read only
+        bool attach(const string& name);
+
+        bool valid() const { return header != nullptr; }
+        bool writable() const { return writer; }
+        const string& name() const { return segment_name; }
+
+        // plays a game, the writer learns from a wrong guess, readers don't
+        animal_tree::GameResult play_game(animal_tree::Player& player);
+
+        // flips the animal at path, writer only, false if path doesn't end
+        // at an animal or the segment is full
+        bool learn(const string& path, const string& question, const string& animal);
+
+        size_t nodes() const;
+        size_t used() const;
+        size_t capacity() const;
+
+    private:
+        string segment_name;
+        char* base;
+        Header* header;
+        size_t mapped;
+        bool writer;
+        unordered_map<string, uint32_t> texts;  // writer's pool: text -> offset
+
+        SharedTree(const SharedTree&);
+        SharedTree& operator=(const SharedTree&);
+
+        const Node& node_at(uint32_t offset) const;
+        string text_of(const Node& node) const;
+        uint32_t allocate(size_t bytes);
+        uint32_t add_text(const string& text);
+        uint32_t add_node(uint32_t yes, uint32_t no, uint32_t text, uint32_t length);
+        void release();
+    };
+
+}  // namespace shared_tree
+
+#endif  // SHARED_TREE_HPP
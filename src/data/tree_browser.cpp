@@ -0,0 +1,237 @@
+/*
+ * Tree Browser Implementation
+ * file: tree_browser.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to browse a tree a page at a time
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ */
+
+#include "tree_browser.hpp"
+
+#include "global.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_browser {
+
+    TreeBrowser::TreeBrowser(const AnimalNode* root, size_t page_rows)
+        : root(root), rows(page_rows ? page_rows : 1) {
+        if (root) {
+            top.nodes.push_back(root);
+        }
+    }
+
+    bool TreeBrowser::is_expanded(const AnimalNode* node) const {
+        return node->is_question() && expanded.count(node);
+    }
+
+    /**
+     * @brief Moves position to the next node in preorder.
+     *
+     * @param position The node to move from.
+     * @param visible_only Skip the branches of collapsed questions.
+     * @return False if position is the last node, position is left as is.
+     */
+    bool TreeBrowser::step_forward(Position& position, bool visible_only) const {
+        const AnimalNode* node = position.nodes.back();
+        if (node->is_question() && (!visible_only || is_expanded(node))) {
+            position.nodes.push_back(node->yes_branch);
+            position.path += 'y';
+            return true;
+        }
+        // up to the first ancestor reached through its yes branch
+        size_t depth = position.path.size();
+        while (depth > 0 && position.path[depth - 1] == 'n') {
+            depth--;
+        }
+        if (depth == 0) {
+            return false;
+        }
+        position.nodes.resize(depth);
+        position.path.resize(depth - 1);
+        position.nodes.push_back(position.nodes.back()->no_branch);
+        position.path += 'n';
+        return true;
+    }
+
+    /**
+     * @brief Moves position to the previous visible node in preorder.
+     *
+     * @return False if position is the root.
+     */
+    bool TreeBrowser::step_back(Position& position) const {
+        if (position.path.empty()) {
+            return false;
+        }
+        char came_from = position.path[position.path.size() - 1];
+        position.nodes.pop_back();
+        position.path.erase(position.path.size() - 1);
+        if (came_from == 'y') {
+            return true;
+        }
+        // the last visible node of the yes sibling
+        position.nodes.push_back(position.nodes.back()->yes_branch);
+        position.path += 'y';
+        while (is_expanded(position.nodes.back())) {
+            position.nodes.push_back(position.nodes.back()->no_branch);
+            position.path += 'n';
+        }
+        return true;
+    }
+
+    /**
+     * @brief Finds the node at path.
+     *
+     * @return False if path leaves the tree or has characters other than y/n.
+     */
+    bool TreeBrowser::locate(const string& path, Position& position) const {
+        if (!root) {
+            return false;
+        }
+        position.nodes.assign(1, root);
+        position.path.clear();
+        for (char answer : path) {
+            const AnimalNode* node = position.nodes.back();
+            if (!node->is_question() || (answer != 'y' && answer != 'n')) {
+                return false;
+            }
+            position.nodes.push_back(answer == 'y' ? node->yes_branch : node->no_branch);
+            position.path += answer;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Counts the nodes of a subtree, up to SIZE_LIMIT, and caches it.
+     */
+    size_t TreeBrowser::subtree_size(const AnimalNode* node) {
+        unordered_map<const AnimalNode*, size_t>::iterator cached = sizes.find(node);
+        if (cached != sizes.end()) {
+            return cached->second;
+        }
+        size_t count = 0;
+        vector<const AnimalNode*> pending(1, node);
+        while (!pending.empty() && count < SIZE_LIMIT) {
+            const AnimalNode* current = pending.back();
+            pending.pop_back();
+            count++;
+            if (current->is_question()) {
+                pending.push_back(current->yes_branch);
+                pending.push_back(current->no_branch);
+            }
+        }
+        sizes[node] = count;
+        return count;
+    }
+
+    vector<Row> TreeBrowser::page() {
+        vector<Row> shown;
+        if (top.nodes.empty()) {
+            return shown;
+        }
+        Position position = top;
+        do {
+            const AnimalNode* node = position.nodes.back();
+            Row row;
+            row.node = node;
+            row.path = position.path;
+            row.expanded = is_expanded(node);
+            row.subtree = node->is_question() && !row.expanded ? subtree_size(node) : 1;
+            shown.push_back(row);
+        } while (shown.size() < rows && step_forward(position, true));
+        return shown;
+    }
+
+    bool TreeBrowser::next_page() {
+        if (top.nodes.empty()) {
+            return false;
+        }
+        Position position = top;
+        for (size_t i = 0; i < rows; i++) {
+            if (!step_forward(position, true)) {
+                return false;
+            }
+        }
+        top = position;
+        return true;
+    }
+
+    bool TreeBrowser::previous_page() {
+        if (top.nodes.empty() || top.path.empty()) {
+            return false;
+        }
+        for (size_t i = 0; i < rows && step_back(top); i++) {
+        }
+        return true;
+    }
+
+    bool TreeBrowser::expand(const string& path) {
+        Position position;
+        if (!locate(path, position) || !position.nodes.back()->is_question()) {
+            return false;
+        }
+        expanded.insert(position.nodes.back());
+        return true;
+    }
+
+    /**
+     * @brief Hides the branches of the question at path.
+     *
+     * If the window starts inside the hidden branches it moves up to the
+     * collapsed question.
+     */
+    bool TreeBrowser::collapse(const string& path) {
+        Position position;
+        if (!locate(path, position) || !expanded.erase(position.nodes.back())) {
+            return false;
+        }
+        if (top.path.size() > path.size() && top.path.compare(0, path.size(), path) == 0) {
+            top = position;
+        }
+        return true;
+    }
+
+    bool TreeBrowser::jump(const string& path) {
+        Position position;
+        if (!locate(path, position)) {
+            return false;
+        }
+        for (size_t i = 0; i + 1 < position.nodes.size(); i++) {
+            expanded.insert(position.nodes[i]);
+        }
+        top = position;
+        return true;
+    }
+
+    /**
+     * @brief Searches every node after the window's first one, hidden or not,
+     * wrapping around to the root once.
+     */
+    bool TreeBrowser::search(const string& text) {
+        if (top.nodes.empty()) {
+            return false;
+        }
+        string wanted = global::fncs::to_lower(text);
+        Position position = top;
+        while (true) {
+            if (!step_forward(position, false)) {
+                position.nodes.assign(1, root);
+                position.path.clear();
+            }
+            if (global::fncs::contains(global::fncs::to_lower(position.nodes.back()->str),
+                                       wanted)) {
+                return jump(position.path);
+            }
+            if (position.nodes.back() == top.nodes.back()) {
+                return false;
+            }
+        }
+    }
+
+}  // namespace tree_browser
@@ -0,0 +1,92 @@
+/*
+ * Tree Browser
+ * file: tree_browser.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * pages through a tree of any size a screen at a time: subtrees are shown
+ * collapsed until expanded, nodes are addressed by their path of answers
+ * ("" is the root, "yn" the no branch of the yes branch of the root)
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *
+ * notes:
+ * - the window is a position in the preorder of the visible nodes. Moving it
+ *   a page steps node by node from there, so a page costs its rows no matter
+ *   how large the tree is.
+ * - subtree sizes are counted the first time a collapsed node is shown and
+ *   cached. The count stops at SIZE_LIMIT nodes, so a row never costs more
+ *   than that.
+ * - the tree must not change while it is being browsed.
+ */
+
+#ifndef TREE_BROWSER_HPP
+#define TREE_BROWSER_HPP
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "animal_node.hpp"
+
+using namespace std;
+
+namespace tree_browser {
+
+    const size_t SIZE_LIMIT = 1 << 20;
+
+    struct Row {
+        const animal_node::AnimalNode* node;
+        string path;
+        bool expanded;
+        size_t subtree;      // nodes under and including node, capped at SIZE_LIMIT
+    };
+
+    struct TreeBrowser {
+        TreeBrowser(const animal_node::AnimalNode* root, size_t page_rows);
+
+        // the rows of the window
+        vector<Row> page();
+
+        // move the window, false if there is nothing there
+        bool next_page();
+        bool previous_page();
+
+        // shows or hides the branches of the question at path
+        bool expand(const string& path);
+        bool collapse(const string& path);
+
+        // expands the way to path and moves the window there
+        bool jump(const string& path);
+
+        // moves the window to the next node (wrapping around) whose text
+        // contains text, ignoring case
+        bool search(const string& text);
+
+    private:
+        // root to a node, nodes.back() is the node
+        struct Position {
+            vector<const animal_node::AnimalNode*> nodes;
+            string path;
+        };
+
+        const animal_node::AnimalNode* root;
+        size_t rows;
+        Position top;
+        unordered_set<const animal_node::AnimalNode*> expanded;
+        unordered_map<const animal_node::AnimalNode*, size_t> sizes;
+
+        bool is_expanded(const animal_node::AnimalNode* node) const;
+        bool step_forward(Position& position, bool visible_only) const;
+        bool step_back(Position& position) const;
+        bool locate(const string& path, Position& position) const;
+        size_t subtree_size(const animal_node::AnimalNode* node);
+    };
+
+}  // namespace tree_browser
+
+#endif  // TREE_BROWSER_HPP
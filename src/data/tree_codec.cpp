@@ -0,0 +1,258 @@
+/*
+ * Compressed Tree Format Implementation
+ * file: tree_codec.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to write and read the compressed knowledge base
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - loaded trees are hashed
+ */
+
+#include "tree_codec.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "output.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_codec {
+
+    bool is_compressed(const char* data, size_t size) {
+        return size >= MAGIC_SIZE && memcmp(data, MAGIC, MAGIC_SIZE) == 0;
+    }
+
+    static void put_varint(string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    // compares the strings behind two pointers
+    static bool text_less(const string* a, const string* b) {
+        return *a < *b;
+    }
+
+    /**
+     * @brief Writes the subtree in the compressed format.
+     *
+     * @param root The subtree to be written.
+     * @param output_stream Where the database is written to, opened in binary.
+     * @param progress Optional counter of written nodes.
+     */
+    void save(const AnimalNode* root, ostream& output_stream, atomic<size_t>* progress) {
+        // preorder walk, the same one load rebuilds the tree with
+        vector<const AnimalNode*> nodes;
+        vector<const AnimalNode*> pending;
+        if (root) {
+            pending.push_back(root);
+        }
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back();
+            pending.pop_back();
+            nodes.push_back(node);
+            if (node->is_question()) {
+                pending.push_back(node->no_branch);
+                pending.push_back(node->yes_branch);
+            }
+        }
+
+        vector<const string*> dictionary(nodes.size());
+        for (size_t i = 0; i < nodes.size(); i++) {
+            dictionary[i] = &nodes[i]->str;
+        }
+        sort(dictionary.begin(), dictionary.end(), text_less);
+        dictionary.erase(unique(dictionary.begin(), dictionary.end(),
+                                [](const string* a, const string* b) { return *a == *b; }),
+                         dictionary.end());
+
+        string out(MAGIC, MAGIC_SIZE);
+        out += static_cast<char>(VERSION);
+        put_varint(out, dictionary.size());
+        put_varint(out, nodes.size());
+
+        const string empty;
+        const string* previous = &empty;
+        for (const string* text : dictionary) {
+            size_t shared = 0;
+            size_t limit = min(previous->size(), text->size());
+            while (shared < limit && (*previous)[shared] == (*text)[shared]) {
+                shared++;
+            }
+            put_varint(out, shared);
+            put_varint(out, text->size() - shared);
+            out.append(*text, shared, string::npos);
+            previous = text;
+        }
+
+        size_t shape_at = out.size();
+        out.append((nodes.size() + 7) / 8, '\0');
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i]->is_question()) {
+                out[shape_at + i / 8] |= static_cast<char>(1 << (i % 8));
+            }
+        }
+
+        const size_t PROGRESS_BATCH = 4096;
+        size_t unreported = 0;
+        for (const AnimalNode* node : nodes) {
+            size_t id = lower_bound(dictionary.begin(), dictionary.end(), &node->str, text_less) -
+                        dictionary.begin();
+            put_varint(out, id);
+            if (progress && ++unreported == PROGRESS_BATCH) {
+                progress->fetch_add(unreported);
+                unreported = 0;
+            }
+        }
+        output_stream.write(out.data(), out.size());
+        if (progress) {
+            progress->fetch_add(unreported);
+        }
+    }
+
+    // bounds checked reader over the file contents
+    struct Reader {
+        const unsigned char* at;
+        const unsigned char* end;
+        bool ok;
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (at == end) {
+                    break;
+                }
+                unsigned char byte = *at++;
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            ok = false;
+            return 0;
+        }
+
+        const unsigned char* take(uint64_t bytes) {
+            if (static_cast<uint64_t>(end - at) < bytes) {
+                ok = false;
+                return nullptr;
+            }
+            const unsigned char* taken = at;
+            at += bytes;
+            return taken;
+        }
+    };
+
+    /**
+     * @brief Decodes a compressed database.
+     *
+     * The shape bits are replayed with the same slot stack tree_io::load uses
+     * for the text format. The node count is known up front, so the nodes are
+     * taken from the pool as one block, laid out in preorder.
+     *
+     * @param data The file contents.
+     * @param size Bytes in data.
+     * @return The root of the loaded tree, nullptr if the database is malformed.
+     */
+    AnimalNode* load(const char* data, size_t size) {
+        if (!is_compressed(data, size) || size <= MAGIC_SIZE ||
+            static_cast<unsigned char>(data[MAGIC_SIZE]) != VERSION) {
+            output::error("not a compressed database of version " + to_string(VERSION));
+            return nullptr;
+        }
+        Reader reader = {reinterpret_cast<const unsigned char*>(data) + MAGIC_SIZE + 1,
+                         reinterpret_cast<const unsigned char*>(data) + size, true};
+        uint64_t strings = reader.varint();
+        uint64_t nodes = reader.varint();
+        // every string and node takes at least one byte, bounds the reserves
+        if (!reader.ok || strings > size || nodes > size * 8) {
+            output::error("corrupt compressed database header");
+            return nullptr;
+        }
+
+        // the dictionary is rebuilt into one buffer, string i is
+        // text[offset[i], offset[i + 1])
+        string text;
+        vector<size_t> offset(1, 0);
+        offset.reserve(strings + 1);
+        for (uint64_t i = 0; i < strings && reader.ok; i++) {
+            uint64_t shared = reader.varint();
+            uint64_t suffix = reader.varint();
+            const unsigned char* bytes = reader.take(suffix);
+            size_t previous = i == 0 ? 0 : offset[i] - offset[i - 1];
+            if (!reader.ok || shared > previous) {
+                reader.ok = false;
+                break;
+            }
+            size_t start = offset[i];
+            text.resize(start + shared);
+            copy(text.begin() + (start - previous), text.begin() + (start - previous + shared),
+                 text.begin() + start);
+            text.append(reinterpret_cast<const char*>(bytes), suffix);
+            offset.push_back(text.size());
+        }
+        const unsigned char* shape = reader.take((nodes + 7) / 8);
+        if (!reader.ok || nodes == 0) {
+            output::error("corrupt compressed database dictionary");
+            return nullptr;
+        }
+
+        // a preorder shape is a whole tree if the open slots run out exactly
+        // at its last node
+        uint64_t open = 1;
+        uint64_t walked = 0;
+        for (; walked < nodes && open > 0; walked++) {
+            if ((shape[walked / 8] >> (walked % 8)) & 1) {
+                open++;
+            } else {
+                open--;
+            }
+        }
+        if (open != 0 || walked != nodes) {
+            output::error("corrupt compressed database tree");
+            return nullptr;
+        }
+
+        // nodes are placed in preorder in one block, node i is block[i]
+        AnimalNode* block = alloc_block(nodes);
+        vector<AnimalNode**> slots;
+        AnimalNode* root = block;
+        for (uint64_t i = 0; i < nodes; i++) {
+            uint64_t id = reader.varint();
+            if (!reader.ok || id >= strings) {
+                reader.ok = false;
+                break;
+            }
+            AnimalNode* node = block + i;
+            if (i > 0) {
+                *slots.back() = node;
+                slots.pop_back();
+            }
+            node->str.assign(text, offset[id], offset[id + 1] - offset[id]);
+            if ((shape[i / 8] >> (i % 8)) & 1) {
+                slots.push_back(&node->no_branch);
+                slots.push_back(&node->yes_branch);
+            }
+        }
+        if (!reader.ok || reader.at != reader.end) {
+            output::error("corrupt compressed database text");
+            for (uint64_t i = 0; i < nodes; i++) {
+                free_node(block + i);
+            }
+            return nullptr;
+        }
+        rehash_tree(root);
+        return root;
+    }
+
+}  // namespace tree_codec
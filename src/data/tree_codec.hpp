@@ -0,0 +1,66 @@
+/*
+ * Compressed Tree Format
+ * file: tree_codec.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * binary variant of the knowledge base that stores every distinct question
+ * and animal once, front coded, and the tree shape as one bit per node
+ *
+ * layout (varint = LEB128, 7 bits per byte, low bits first):
+ *   "AGKB" version(1 byte)
+ *   varint strings, varint nodes
+ *   dictionary: per string, sorted: varint shared prefix with the previous
+ *               string, varint suffix length, suffix bytes
+ *   shape: nodes bits in preorder, 1 question / 0 animal, low bit first
+ *   text: per node in preorder, varint dictionary index
+ *
+ * changelog:
+ *  10/19/2026 - initial design, version 1
+ *
+ * notes:
+ * - sorting puts "Does it ..." questions and repeated animals next to each
+ *   other, so front coding drops most of the shared text.
+ * - the whole file is read with one call and decoded from memory, no line
+ *   parsing, which is what makes it load faster than the text format.
+ */
+
+#ifndef TREE_CODEC_HPP
+#define TREE_CODEC_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "animal_node.hpp"
+
+using namespace std;
+
+namespace tree_codec {
+
+    const char MAGIC[] = "AGKB";
+    const size_t MAGIC_SIZE = 4;
+    const unsigned char VERSION = 1;
+
+    // true if data starts like a compressed database
+    bool is_compressed(const char* data, size_t size);
+
+    /*
+     *  writes the subtree compressed, progress (if given) is advanced by the
+     *  number of nodes written
+     */
+    void save(const animal_node::AnimalNode* root, ostream& output_stream,
+              atomic<size_t>* progress = nullptr);
+
+    /*
+     *  decodes a compressed database held in memory, returns nullptr if it
+     *  is malformed
+     */
+    animal_node::AnimalNode* load(const char* data, size_t size);
+
+}  // namespace tree_codec
+
+#endif  // TREE_CODEC_HPP
@@ -0,0 +1,306 @@
+/*
+ * Tree Compaction Implementation
+ * file: tree_compaction.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to compact a tree
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - subtrees are compared through the nodes' merkle hashes
+ *
+ * notes:
+ * - every pass walks the tree with an explicit stack, like the rest of the
+ *   data module.
+ * - a node being replaced by one of its children takes the child's contents
+ *   in place, so the parent's branch pointer stays valid and the replaced
+ *   node keeps its visit count.
+ */
+
+#include "tree_compaction.hpp"
+
+#include <cstdint>
+#include <iomanip>
+#include <unordered_map>
+#include <vector>
+
+#include "tree_memory.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_compaction {
+
+    static size_t count_nodes(const AnimalNode* root) {
+        size_t nodes = 0;
+        vector<const AnimalNode*> pending(1, root);
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back();
+            pending.pop_back();
+            nodes++;
+            if (node->is_question()) {
+                pending.push_back(node->yes_branch);
+                pending.push_back(node->no_branch);
+            }
+        }
+        return nodes;
+    }
+
+    /**
+     * @brief Replaces a question by one of its branches.
+     *
+     * @param node The question, it takes the contents of the kept branch.
+     * @param keep_yes Keep the yes branch, the no branch otherwise.
+     * @return Nodes of the branch that was cut off and freed.
+     */
+    static size_t replace_with_branch(AnimalNode* node, bool keep_yes) {
+        AnimalNode* kept = keep_yes ? node->yes_branch : node->no_branch;
+        AnimalNode* cut = keep_yes ? node->no_branch : node->yes_branch;
+        size_t freed = count_nodes(cut);
+        free_tree(cut);
+        node->str.swap(kept->str);
+        node->yes_branch = kept->yes_branch;
+        node->no_branch = kept->no_branch;
+        node->hash = kept->hash;
+        free_node(kept);
+        return freed;
+    }
+
+    // true if both subtrees hold the same questions and animals in the same places
+    static bool same_subtree(const AnimalNode* a, const AnimalNode* b) {
+        vector<pair<const AnimalNode*, const AnimalNode*>> pending(1, make_pair(a, b));
+        while (!pending.empty()) {
+            const AnimalNode* x = pending.back().first;
+            const AnimalNode* y = pending.back().second;
+            pending.pop_back();
+            if (x == y) {
+                continue;
+            }
+            if (x->is_question() != y->is_question() || x->str != y->str) {
+                return false;
+            }
+            if (x->is_question()) {
+                pending.push_back(make_pair(x->yes_branch, y->yes_branch));
+                pending.push_back(make_pair(x->no_branch, y->no_branch));
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Replaces the questions already answered higher up their path.
+     *
+     * The answers of the path are kept in a map from question to answer while
+     * the walk goes down, and dropped on the way back up.
+     */
+    static void drop_repeated_questions(AnimalNode* root, CompactionReport& report) {
+        struct Frame {
+            AnimalNode* node;
+            int stage;  // 0 entering, 1 yes branch done, 2 no branch done
+        };
+        unordered_map<string, bool> answered;
+        vector<Frame> frames;
+        Frame first = {root, 0};
+        frames.push_back(first);
+        while (!frames.empty()) {
+            AnimalNode* node = frames.back().node;
+            int stage = frames.back().stage;
+            if (stage == 0) {
+                unordered_map<string, bool>::iterator known;
+                while (node->is_question() &&
+                       (known = answered.find(node->str)) != answered.end()) {
+                    report.repeated_questions++;
+                    report.unreachable_nodes += replace_with_branch(node, known->second);
+                }
+                if (!node->is_question()) {
+                    frames.pop_back();
+                    continue;
+                }
+                answered[node->str] = true;
+                frames.back().stage = 1;
+                Frame yes = {node->yes_branch, 0};
+                frames.push_back(yes);
+            } else if (stage == 1) {
+                answered[node->str] = false;
+                frames.back().stage = 2;
+                Frame no = {node->no_branch, 0};
+                frames.push_back(no);
+            } else {
+                answered.erase(node->str);
+                frames.pop_back();
+            }
+        }
+    }
+
+    /**
+     * @brief Replaces the questions whose branches are identical, bottom up,
+     * so chains of them collapse in one pass.
+     *
+     * Every node is rehashed in postorder on the way, since the repeated
+     * questions dropped before left the hashes above them stale. A collapsed
+     * question takes the hash of the branch it became.
+     */
+    static void drop_redundant_questions(AnimalNode* root, CompactionReport& report) {
+        vector<pair<AnimalNode*, bool>> pending(1, make_pair(root, false));
+        while (!pending.empty()) {
+            AnimalNode* node = pending.back().first;
+            bool children_done = pending.back().second;
+            pending.pop_back();
+            if (!node->is_question()) {
+                node->hash = hash_node(*node);
+                continue;
+            }
+            if (!children_done) {
+                pending.push_back(make_pair(node, true));
+                pending.push_back(make_pair(node->no_branch, false));
+                pending.push_back(make_pair(node->yes_branch, false));
+                continue;
+            }
+            if (node->yes_branch->hash == node->no_branch->hash &&
+                same_subtree(node->yes_branch, node->no_branch)) {
+                report.redundant_questions++;
+                replace_with_branch(node, true);
+            } else {
+                node->hash = hash_node(*node);
+            }
+        }
+    }
+
+    /**
+     * @brief Counts the question subtrees identical to one met earlier in
+     * preorder, without counting the subtrees inside them again.
+     */
+    static void count_duplicates(const AnimalNode* root, CompactionReport& report) {
+        unordered_map<const AnimalNode*, size_t> size_of;
+        vector<pair<const AnimalNode*, bool>> pending(1, make_pair(root, false));
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back().first;
+            bool children_done = pending.back().second;
+            pending.pop_back();
+            if (!node->is_question()) {
+                size_of[node] = 1;
+            } else if (!children_done) {
+                pending.push_back(make_pair(node, true));
+                pending.push_back(make_pair(node->no_branch, false));
+                pending.push_back(make_pair(node->yes_branch, false));
+            } else {
+                size_of[node] = 1 + size_of[node->yes_branch] + size_of[node->no_branch];
+            }
+        }
+
+        unordered_multimap<uint64_t, const AnimalNode*> seen;
+        vector<const AnimalNode*> preorder(1, root);
+        while (!preorder.empty()) {
+            const AnimalNode* node = preorder.back();
+            preorder.pop_back();
+            if (!node->is_question()) {
+                continue;
+            }
+            uint64_t node_hash = node->hash;
+            bool duplicate = false;
+            auto range = seen.equal_range(node_hash);
+            for (auto it = range.first; it != range.second && !duplicate; ++it) {
+                duplicate = same_subtree(it->second, node);
+            }
+            if (duplicate) {
+                report.duplicate_subtrees++;
+                report.duplicate_nodes += size_of[node];
+                continue;
+            }
+            seen.insert(make_pair(node_hash, node));
+            preorder.push_back(node->no_branch);
+            preorder.push_back(node->yes_branch);
+        }
+    }
+
+    Shape shape_of(const AnimalNode* root) {
+        Shape shape;
+        shape.nodes = 0;
+        shape.max_depth = 0;
+        shape.average_depth = 0;
+        shape.bytes = tree_memory::measure(root).total_bytes();
+
+        size_t leaves = 0;
+        size_t depth_sum = 0;
+        vector<pair<const AnimalNode*, size_t>> pending;
+        if (root) {
+            pending.push_back(make_pair(root, 0));
+        }
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back().first;
+            size_t depth = pending.back().second;
+            pending.pop_back();
+            shape.nodes++;
+            if (node->is_question()) {
+                pending.push_back(make_pair(node->yes_branch, depth + 1));
+                pending.push_back(make_pair(node->no_branch, depth + 1));
+            } else {
+                leaves++;
+                depth_sum += depth;
+                shape.max_depth = max(shape.max_depth, depth);
+            }
+        }
+        if (leaves) {
+            shape.average_depth = static_cast<double>(depth_sum) / leaves;
+        }
+        return shape;
+    }
+
+    /**
+     * @brief Compacts the tree and gives the emptied pool slabs back.
+     *
+     * @param tree The tree to be compacted.
+     * @return What was removed and the shape before and after.
+     */
+    CompactionReport compact(animal_tree::AnimalTree& tree) {
+        CompactionReport report;
+        report.repeated_questions = 0;
+        report.unreachable_nodes = 0;
+        report.redundant_questions = 0;
+        report.duplicate_subtrees = 0;
+        report.duplicate_nodes = 0;
+        report.before = shape_of(tree.root);
+        if (tree.root) {
+            drop_repeated_questions(tree.root, report);
+            drop_redundant_questions(tree.root, report);
+            count_duplicates(tree.root, report);
+        }
+        report.pool_bytes_released = trim_pool();
+        report.after = shape_of(tree.root);
+        return report;
+    }
+
+    void print(const CompactionReport& report, ostream& output_stream) {
+        ios::fmtflags flags = output_stream.flags();
+        streamsize precision = output_stream.precision();
+        output_stream << fixed << setprecision(2);
+        output_stream << left << setw(36) << "" << right << setw(14) << "before" << setw(14)
+                      << "after" << endl;
+        output_stream << left << setw(36) << "nodes" << right << setw(14) << report.before.nodes
+                      << setw(14) << report.after.nodes << endl;
+        output_stream << left << setw(36) << "max depth" << right << setw(14)
+                      << report.before.max_depth << setw(14) << report.after.max_depth << endl;
+        output_stream << left << setw(36) << "average leaf depth" << right << setw(14)
+                      << report.before.average_depth << setw(14) << report.after.average_depth
+                      << endl;
+        output_stream << left << setw(36) << "tree bytes" << right << setw(14)
+                      << report.before.bytes << setw(14) << report.after.bytes << endl;
+        output_stream << left << setw(36) << "repeated questions removed" << right << setw(14)
+                      << report.repeated_questions << endl;
+        output_stream << left << setw(36) << "unreachable nodes freed" << right << setw(14)
+                      << report.unreachable_nodes << endl;
+        output_stream << left << setw(36) << "questions with identical branches" << right
+                      << setw(14) << report.redundant_questions << endl;
+        output_stream << left << setw(36) << "duplicate subtrees (kept)" << right << setw(14)
+                      << report.duplicate_subtrees << endl;
+        output_stream << left << setw(36) << "nodes in duplicate subtrees" << right << setw(14)
+                      << report.duplicate_nodes << endl;
+        output_stream << left << setw(36) << "pool bytes given back" << right << setw(14)
+                      << report.pool_bytes_released << endl;
+        output_stream.flags(flags);
+        output_stream.precision(precision);
+    }
+
+}  // namespace tree_compaction
@@ -0,0 +1,66 @@
+/*
+ * Tree Compaction
+ * file: tree_compaction.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * removes the nodes the learn-on-miss flow leaves behind without a purpose
+ * and gives their memory back
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *
+ * notes:
+ * - a question asked again below itself already has its answer, the copy is
+ *   replaced by the branch that answer leads to and the other branch, which
+ *   no game can reach, is freed.
+ * - a question whose yes and no subtrees are identical (same hash, then
+ *   compared node by node) tells nothing apart, it is replaced by one of them
+ *   and the other one is freed.
+ * - identical subtrees under different questions are counted but stay
+ *   separate: sharing them would make a lesson learned in one context show
+ *   up in the others.
+ */
+
+#ifndef TREE_COMPACTION_HPP
+#define TREE_COMPACTION_HPP
+
+#include <cstddef>
+#include <iostream>
+
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace tree_compaction {
+
+    struct Shape {
+        size_t nodes;
+        size_t max_depth;       // questions on the longest path
+        double average_depth;   // questions to reach a leaf, over every leaf
+        size_t bytes;           // tree_memory footprint
+    };
+
+    struct CompactionReport {
+        Shape before;
+        Shape after;
+        size_t repeated_questions;   // questions answered higher up the path
+        size_t unreachable_nodes;    // freed with the branches they cut off
+        size_t redundant_questions;  // questions with identical branches
+        size_t duplicate_subtrees;   // identical subtrees under different questions
+        size_t duplicate_nodes;      // nodes of those subtrees, past the first copy
+        size_t pool_bytes_released;  // empty pool slabs given back to the system
+    };
+
+    Shape shape_of(const animal_node::AnimalNode* root);
+
+    // compacts tree in place
+    CompactionReport compact(animal_tree::AnimalTree& tree);
+
+    void print(const CompactionReport& report, ostream& output_stream);
+
+}  // namespace tree_compaction
+
+#endif  // TREE_COMPACTION_HPP
@@ -0,0 +1,122 @@
+/*
+ * Tree Diff Implementation
+ * file: tree_diff.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to compare trees by their merkle hashes
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ */
+
+#include "tree_diff.hpp"
+
+#include <cstdint>
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_diff {
+
+    bool same(const AnimalNode* a, const AnimalNode* b) {
+        if (!a || !b) {
+            return a == b;
+        }
+        return a->hash == b->hash;
+    }
+
+    /**
+     * @brief Walks both trees together, only into the pairs whose hashes
+     * differ.
+     *
+     * @param a The tree compared from.
+     * @param b The tree compared to.
+     * @param limit Changes after which the walk stops.
+     * @return The changes, highest subtree first.
+     */
+    DiffReport diff(const AnimalNode* a, const AnimalNode* b, size_t limit) {
+        DiffReport report;
+        report.compared = 0;
+        report.truncated = false;
+
+        struct Pair {
+            const AnimalNode* before;
+            const AnimalNode* after;
+            string path;
+        };
+        vector<Pair> pending;
+        Pair roots = {a, b, ""};
+        pending.push_back(roots);
+        while (!pending.empty()) {
+            Pair pair = pending.back();
+            pending.pop_back();
+            report.compared++;
+            if (same(pair.before, pair.after)) {
+                continue;
+            }
+            if (pair.before && pair.after && pair.before->is_question() &&
+                pair.after->is_question() && pair.before->str == pair.after->str) {
+                Pair no = {pair.before->no_branch, pair.after->no_branch, pair.path + 'n'};
+                Pair yes = {pair.before->yes_branch, pair.after->yes_branch, pair.path + 'y'};
+                pending.push_back(no);
+                pending.push_back(yes);
+                continue;
+            }
+            if (report.changes.size() == limit) {
+                report.truncated = true;
+                break;
+            }
+            Change change = {pair.path, pair.before, pair.after};
+            report.changes.push_back(change);
+        }
+        return report;
+    }
+
+    static size_t count_nodes(const AnimalNode* root) {
+        size_t nodes = 0;
+        vector<const AnimalNode*> pending;
+        if (root) {
+            pending.push_back(root);
+        }
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back();
+            pending.pop_back();
+            nodes++;
+            if (node->is_question()) {
+                pending.push_back(node->yes_branch);
+                pending.push_back(node->no_branch);
+            }
+        }
+        return nodes;
+    }
+
+    static void print_side(char sign, const AnimalNode* node, ostream& output_stream) {
+        output_stream << sign << ' ';
+        if (!node) {
+            output_stream << "(nothing)";
+        } else if (node->is_question()) {
+            output_stream << "Q " << node->str << " (" << count_nodes(node) << " nodes)";
+        } else {
+            output_stream << "G " << node->str;
+        }
+        output_stream << '\n';
+    }
+
+    void print(const DiffReport& report, ostream& output_stream) {
+        if (report.changes.empty()) {
+            output_stream << "the trees are the same (" << report.compared
+                          << " node pairs compared)\n";
+            return;
+        }
+        for (const Change& change : report.changes) {
+            output_stream << "@ " << (change.path.empty() ? "-" : change.path) << '\n';
+            print_side('-', change.before, output_stream);
+            print_side('+', change.after, output_stream);
+        }
+        output_stream << report.changes.size() << (report.truncated ? "+" : "")
+                      << " changes, " << report.compared << " node pairs compared\n";
+    }
+
+}  // namespace tree_diff
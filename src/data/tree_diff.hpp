@@ -0,0 +1,68 @@
+/*
+ * Tree Diff
+ * file: tree_diff.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * compares two trees through the merkle hashes of their nodes, e.g. the tree
+ * in memory and the database it was saved to, or a leader and a follower
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *
+ * notes:
+ * - a pair of subtrees with the same hash is taken as equal without walking
+ *   it, so the cost is the number of nodes above the changes rather than the
+ *   size of the trees.
+ * - a change is the highest subtree that differs: two questions with the
+ *   same text are descended into, anything else is reported whole. A learned
+ *   animal is therefore one change, the animal replaced by its new question.
+ */
+
+#ifndef TREE_DIFF_HPP
+#define TREE_DIFF_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "animal_node.hpp"
+
+using namespace std;
+
+namespace tree_diff {
+
+    struct Change {
+        string path;                              // from the root, "" is the root
+        const animal_node::AnimalNode* before;    // subtree in the first tree
+        const animal_node::AnimalNode* after;     // subtree in the second tree
+    };
+
+    struct DiffReport {
+        vector<Change> changes;  // in preorder
+        size_t compared;         // node pairs looked at
+        bool truncated;          // stopped at the change limit
+    };
+
+    // true if both trees hash the same
+    bool same(const animal_node::AnimalNode* a, const animal_node::AnimalNode* b);
+
+    // changes turning tree a into tree b, at most limit of them
+    DiffReport diff(const animal_node::AnimalNode* a, const animal_node::AnimalNode* b,
+                    size_t limit = SIZE_MAX);
+
+    /*
+     *  one block per change:
+     *    @ <path or ->
+     *    - <G animal | Q question (n nodes)>
+     *    + <G animal | Q question (n nodes)>
+     */
+    void print(const DiffReport& report, ostream& output_stream);
+
+}  // namespace tree_diff
+
+#endif  // TREE_DIFF_HPP
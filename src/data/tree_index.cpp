@@ -0,0 +1,231 @@
+/*
+ * Tree Index Implementation
+ * file: tree_index.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to index the text of a tree
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ */
+
+#include "tree_index.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_index {
+
+    vector<string> tokenize(const string& text) {
+        vector<string> tokens;
+        string token;
+        for (char ch : text) {
+            if (isalnum(static_cast<unsigned char>(ch))) {
+                token += static_cast<char>(tolower(static_cast<unsigned char>(ch)));
+            } else if (!token.empty()) {
+                tokens.push_back(token);
+                token.clear();
+            }
+        }
+        if (!token.empty()) {
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+
+    // orders word ids by their words
+    struct WordOrder {
+        const vector<const string*>& word_of;
+        explicit WordOrder(const vector<const string*>& word_of) : word_of(word_of) {}
+        bool operator()(uint32_t a, uint32_t b) const { return *word_of[a] < *word_of[b]; }
+        bool operator()(uint32_t a, const string& b) const { return *word_of[a] < b; }
+    };
+
+    /**
+     * @brief Indexes the tree: entries first, in preorder with an explicit
+     * stack, then their words once the number of nodes is known.
+     *
+     * @param root The tree to be indexed, may be null.
+     */
+    TreeIndex::TreeIndex(const AnimalNode* root) : building(true) {
+        if (root) {
+            Entry entry = {root, NO_PARENT, false, true};
+            entries.push_back(entry);
+            vector<uint32_t> pending(1, 0);
+            while (!pending.empty()) {
+                uint32_t id = pending.back();
+                pending.pop_back();
+                const AnimalNode* node = entries[id].node;
+                if (node->is_question()) {
+                    Entry no = {node->no_branch, id, false, true};
+                    Entry yes = {node->yes_branch, id, true, true};
+                    pending.push_back(static_cast<uint32_t>(entries.size()));
+                    entries.push_back(no);
+                    pending.push_back(static_cast<uint32_t>(entries.size()));
+                    entries.push_back(yes);
+                }
+            }
+        }
+        by_node.reserve(entries.size());
+        for (uint32_t id = 0; id < entries.size(); id++) {
+            index_words(id);
+        }
+        sort(sorted_words.begin(), sorted_words.end(), WordOrder(word_of));
+        building = false;
+    }
+
+    /**
+     * @brief Adds entry id to the postings of word. New words are kept in
+     * order right away once the index is built, a flip adds few of them.
+     */
+    void TreeIndex::post(const string& word, uint32_t id) {
+        pair<unordered_map<string, uint32_t>::iterator, bool> inserted =
+            word_ids.insert(make_pair(word, static_cast<uint32_t>(postings.size())));
+        uint32_t word_id = inserted.first->second;
+        if (inserted.second) {
+            postings.push_back(vector<uint32_t>());
+            word_of.push_back(&inserted.first->first);
+            vector<uint32_t>::iterator at =
+                building ? sorted_words.end()
+                         : lower_bound(sorted_words.begin(), sorted_words.end(), word,
+                                       WordOrder(word_of));
+            sorted_words.insert(at, word_id);
+        }
+        vector<uint32_t>& posting = postings[word_id];
+        if (posting.empty() || posting.back() != id) {
+            posting.push_back(id);
+        }
+    }
+
+    /**
+     * @brief Makes entry id the node's entry and posts it under each of its
+     * words once.
+     */
+    void TreeIndex::index_words(uint32_t id) {
+        const AnimalNode* node = entries[id].node;
+        by_node[node] = id;
+        string word;
+        for (char ch : node->str) {
+            if (isalnum(static_cast<unsigned char>(ch))) {
+                word += static_cast<char>(tolower(static_cast<unsigned char>(ch)));
+            } else if (!word.empty()) {
+                post(word, id);
+                word.clear();
+            }
+        }
+        if (!word.empty()) {
+            post(word, id);
+        }
+    }
+
+    uint32_t TreeIndex::add(const AnimalNode* node, uint32_t parent, bool yes) {
+        uint32_t id = static_cast<uint32_t>(entries.size());
+        Entry entry = {node, parent, yes, true};
+        entries.push_back(entry);
+        index_words(id);
+        return id;
+    }
+
+    /**
+     * @brief Follows a flip: the node's old entry (its animal) is retired,
+     * the question and both of its animals get new ones.
+     *
+     * The postings of the retired entry are left in place and skipped by the
+     * queries, a flip only adds.
+     *
+     * @param question The node that was just flipped, its entry knows its path.
+     */
+    void TreeIndex::on_flip(const AnimalNode* question, const string&) {
+        unordered_map<const AnimalNode*, uint32_t>::iterator found = by_node.find(question);
+        if (found == by_node.end()) {
+            return;
+        }
+        uint32_t old_id = found->second;
+        entries[old_id].live = false;
+        uint32_t id = add(question, entries[old_id].parent, entries[old_id].yes);
+        add(question->yes_branch, id, true);
+        add(question->no_branch, id, false);
+    }
+
+    string TreeIndex::path_of(uint32_t id) const {
+        string path;
+        while (entries[id].parent != NO_PARENT) {
+            path += entries[id].yes ? 'y' : 'n';
+            id = entries[id].parent;
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    vector<Hit> TreeIndex::hits(const vector<uint32_t>& ids, size_t limit) const {
+        vector<Hit> found;
+        for (size_t i = 0; i < ids.size() && found.size() < limit; i++) {
+            if (entries[ids[i]].live) {
+                Hit hit = {entries[ids[i]].node, path_of(ids[i])};
+                found.push_back(hit);
+            }
+        }
+        return found;
+    }
+
+    size_t TreeIndex::live(const vector<uint32_t>& ids) const {
+        size_t total = 0;
+        for (uint32_t id : ids) {
+            total += entries[id].live;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Merges the postings of every word starting with prefix.
+     *
+     * @return Entry ids, sorted and without repeats.
+     */
+    vector<uint32_t> TreeIndex::matching_prefix(const string& prefix) const {
+        string lowered = global::fncs::to_lower(prefix);
+        vector<uint32_t> ids;
+        size_t words = 0;
+        vector<uint32_t>::const_iterator word = lower_bound(
+            sorted_words.begin(), sorted_words.end(), lowered, WordOrder(word_of));
+        for (; word != sorted_words.end() &&
+               word_of[*word]->compare(0, lowered.size(), lowered) == 0;
+             ++word) {
+            ids.insert(ids.end(), postings[*word].begin(), postings[*word].end());
+            words++;
+        }
+        if (words > 1) {
+            sort(ids.begin(), ids.end());
+            ids.erase(unique(ids.begin(), ids.end()), ids.end());
+        }
+        return ids;
+    }
+
+    vector<Hit> TreeIndex::find(const string& word, size_t limit) const {
+        unordered_map<string, uint32_t>::const_iterator found =
+            word_ids.find(global::fncs::to_lower(word));
+        if (found == word_ids.end()) {
+            return vector<Hit>();
+        }
+        return hits(postings[found->second], limit);
+    }
+
+    vector<Hit> TreeIndex::find_prefix(const string& prefix, size_t limit) const {
+        return hits(matching_prefix(prefix), limit);
+    }
+
+    size_t TreeIndex::count(const string& word) const {
+        unordered_map<string, uint32_t>::const_iterator found =
+            word_ids.find(global::fncs::to_lower(word));
+        return found == word_ids.end() ? 0 : live(postings[found->second]);
+    }
+
+    size_t TreeIndex::count_prefix(const string& prefix) const {
+        return live(matching_prefix(prefix));
+    }
+
+}  // namespace tree_index
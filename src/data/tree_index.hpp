@@ -0,0 +1,97 @@
+/*
+ * Tree Index
+ * file: tree_index.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * finds the questions and animals whose text holds a word, or a word
+ * starting with a prefix, without walking the tree
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *
+ * notes:
+ * - words are the runs of letters and digits of a node's text, lower cased
+ *   like global::fncs::to_lower. Every word maps to the entries holding it.
+ * - an entry is a node and the entry of its parent, the path of a hit is
+ *   rebuilt by following parents, so only the hits pay for their paths.
+ * - the index observes the tree: a flip retires the entry of the old animal
+ *   and adds the question and its two animals, no rebuild needed. Anything
+ *   else that changes the tree (compaction, layout, a new tree) needs a new
+ *   index.
+ * - not thread safe, use it from the thread that changes the tree.
+ */
+
+#ifndef TREE_INDEX_HPP
+#define TREE_INDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace tree_index {
+
+    struct Hit {
+        const animal_node::AnimalNode* node;
+        string path;  // answers from the root, 'y' or 'n' per question
+    };
+
+    // lower cased words of text, in order, repeats included
+    vector<string> tokenize(const string& text);
+
+    struct TreeIndex : animal_tree::TreeObserver {
+        // indexes every node under root
+        explicit TreeIndex(const animal_node::AnimalNode* root);
+
+        // nodes holding word, at most limit of them, in the order they were indexed
+        vector<Hit> find(const string& word, size_t limit = SIZE_MAX) const;
+
+        // nodes holding a word that starts with prefix
+        vector<Hit> find_prefix(const string& prefix, size_t limit = SIZE_MAX) const;
+
+        // number of nodes the queries above would return without a limit
+        size_t count(const string& word) const;
+        size_t count_prefix(const string& prefix) const;
+
+        size_t nodes() const { return by_node.size(); }
+        size_t words() const { return postings.size(); }
+
+        void on_flip(const animal_node::AnimalNode* question, const string& path);
+
+    private:
+        static const uint32_t NO_PARENT = UINT32_MAX;
+
+        struct Entry {
+            const animal_node::AnimalNode* node;
+            uint32_t parent;
+            bool yes;    // node is the yes branch of parent
+            bool live;   // false once node no longer holds this entry's text
+        };
+
+        vector<Entry> entries;
+        unordered_map<const animal_node::AnimalNode*, uint32_t> by_node;
+        unordered_map<string, uint32_t> word_ids;
+        vector<vector<uint32_t>> postings;   // entries holding each word
+        vector<const string*> word_of;       // keys of word_ids, by word id
+        vector<uint32_t> sorted_words;       // word ids in word order, for prefixes
+        bool building;                       // sorted_words is sorted once built
+
+        uint32_t add(const animal_node::AnimalNode* node, uint32_t parent, bool yes);
+        void index_words(uint32_t id);
+        void post(const string& word, uint32_t id);
+        vector<uint32_t> matching_prefix(const string& prefix) const;
+        vector<Hit> hits(const vector<uint32_t>& ids, size_t limit) const;
+        size_t live(const vector<uint32_t>& ids) const;
+        string path_of(uint32_t id) const;
+    };
+
+}  // namespace tree_index
+
+#endif  // TREE_INDEX_HPP
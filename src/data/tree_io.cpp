@@ -0,0 +1,230 @@
+/*
+ * Tree Persistence Implementation
+ * file: tree_io.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to save and load the knowledge base
+ *
+ * changelog:
+ *  10/19/2026 - initial text format, file helpers
+ *  10/19/2026 - load and save latencies recorded into metrics
+ *  10/19/2026 - progress counter, the saved file is synced before the rename
+ *  10/19/2026 - compressed format, detected by load_file
+ *  10/19/2026 - loaded trees are hashed
+ *
+ * notes:
+ * - both directions walk the tree with an explicit stack, trees grown by the
+ *   learn-on-miss flow can be far deeper than the call stack allows.
+ */
+
+#include "tree_io.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <vector>
+
+#include "metrics.hpp"
+#include "output.hpp"
+#include "tree_codec.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_io {
+
+    /**
+     * @brief Writes the subtree in preorder, one node per line.
+     *
+     * @param root The subtree to be written.
+     * @param output_stream Where the database is written to.
+     * @param progress Optional counter of written nodes, advanced in batches.
+     */
+    void save(const AnimalNode* root, ostream& output_stream, atomic<size_t>* progress) {
+        const size_t PROGRESS_BATCH = 4096;
+        size_t unreported = 0;
+        vector<const AnimalNode*> pending;
+        if (root) {
+            pending.push_back(root);
+        }
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back();
+            pending.pop_back();
+            if (node->is_question()) {
+                output_stream << "Q " << node->str << '\n';
+                pending.push_back(node->no_branch);
+                pending.push_back(node->yes_branch);
+            } else {
+                output_stream << "G " << node->str << '\n';
+            }
+            if (progress && ++unreported == PROGRESS_BATCH) {
+                progress->fetch_add(unreported);
+                unreported = 0;
+            }
+        }
+        if (progress) {
+            progress->fetch_add(unreported);
+        }
+    }
+
+    /**
+     * @brief Parses a database written by save or print_tree.
+     *
+     * Every parsed node fills the next empty branch slot in preorder. Question
+     * nodes push their no and yes slots, so the yes subtree is read first.
+     *
+     * @param input_stream The database to be read.
+     * @return The root of the loaded tree, nullptr if the database is malformed.
+     */
+    AnimalNode* load(istream& input_stream) {
+        AnimalNode* root = nullptr;
+        vector<AnimalNode**> slots;
+        slots.push_back(&root);
+
+        string line;
+        int line_number = 0;
+        while (!slots.empty() && getline(input_stream, line)) {
+            line_number++;
+            size_t first = line.find_first_not_of(" \t");
+            if (first == string::npos || line[first] == '#') {
+                continue;
+            }
+            char kind = line[first];
+            if ((kind != 'Q' && kind != 'G') || first + 2 > line.size()) {
+                output::error("malformed database line " + to_string(line_number));
+                free_tree(root);
+                return nullptr;
+            }
+            string text = line.substr(first + 2);
+            if (!text.empty() && text[text.size() - 1] == '\r') {
+                text.erase(text.size() - 1);
+            }
+
+            AnimalNode** slot = slots.back();
+            slots.pop_back();
+            *slot = alloc_animal(text);
+            if (kind == 'Q') {
+                slots.push_back(&(*slot)->no_branch);
+                slots.push_back(&(*slot)->yes_branch);
+            }
+        }
+
+        if (!slots.empty()) {
+            output::error("database ended before the tree was complete");
+            free_tree(root);
+            return nullptr;
+        }
+        rehash_tree(root);
+        return root;
+    }
+
+    /**
+     * @brief Saves the tree, atomically replacing whatever is stored at path.
+     *
+     * The tree is written to a temporary file which is synced to disk before
+     * it is renamed over path, so a crash leaves either the old or the new
+     * database, never a half written one.
+     *
+     * @param tree The tree to be saved.
+     * @param path The database file.
+     * @param progress Optional counter of written nodes.
+     * @param format TEXT or COMPRESSED.
+     * @return True if the database was fully written.
+     */
+    bool save_file(const animal_tree::AnimalTree& tree, const string& path,
+                   atomic<size_t>* progress, Format format) {
+        metrics::Timer timer(metrics::SAVE_LATENCY);
+        string tmp_path = path + ".tmp";
+        {
+            ofstream output_file(tmp_path.c_str(), ios::binary);
+            if (!output_file) {
+                output::error("could not open " + tmp_path);
+                return false;
+            }
+            if (format == COMPRESSED) {
+                tree_codec::save(tree.root, output_file, progress);
+            } else {
+                save(tree.root, output_file, progress);
+            }
+            output_file.flush();
+            if (!output_file) {
+                output::error("could not write " + tmp_path);
+                remove(tmp_path.c_str());
+                return false;
+            }
+        }
+        int fd = open(tmp_path.c_str(), O_RDONLY);
+        if (fd < 0 || fsync(fd) != 0) {
+            output::error("could not sync " + tmp_path);
+            if (fd >= 0) {
+                close(fd);
+            }
+            remove(tmp_path.c_str());
+            return false;
+        }
+        close(fd);
+        if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+            output::error("could not replace " + path);
+            remove(tmp_path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads a compressed database whole and decodes it.
+     *
+     * @param input_file The database, positioned at its start.
+     * @return The root of the loaded tree, nullptr if it can't be read.
+     */
+    static AnimalNode* load_compressed(ifstream& input_file) {
+        input_file.seekg(0, ios::end);
+        streamoff size = input_file.tellg();
+        input_file.seekg(0, ios::beg);
+        if (size < 0) {
+            return nullptr;
+        }
+        vector<char> data(static_cast<size_t>(size));
+        if (!input_file.read(data.data(), size)) {
+            output::error("could not read the compressed database");
+            return nullptr;
+        }
+        return tree_codec::load(data.data(), data.size());
+    }
+
+    /**
+     * @brief Loads the tree stored at path, compressed or as text.
+     *
+     * @param path The database file.
+     * @return The root of the loaded tree, nullptr if it can't be read.
+     */
+    AnimalNode* load_file(const string& path) {
+        metrics::Timer timer(metrics::LOAD_LATENCY);
+        ifstream input_file(path.c_str(), ios::binary);
+        if (!input_file) {
+            debug::loaded(path, false);
+            return nullptr;
+        }
+        char header[tree_codec::MAGIC_SIZE];
+        input_file.read(header, sizeof(header));
+        bool compressed = tree_codec::is_compressed(header, input_file.gcount());
+        input_file.clear();
+        input_file.seekg(0, ios::beg);
+
+        AnimalNode* root = compressed ? load_compressed(input_file) : load(input_file);
+        debug::loaded(path, root != nullptr);
+        return root;
+    }
+
+    namespace debug {
+        void loaded(const string& path, bool ok) {
+            if (global::debug_flags::TREE_IO) {
+                output::debug("loading " + path + ": ", ok ? "ok" : "failed");
+            }
+        }
+    }  // namespace debug
+
+}  // namespace tree_io
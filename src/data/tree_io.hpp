@@ -0,0 +1,76 @@
+/*
+ * Tree Persistence
+ * file: tree_io.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * reads and writes the knowledge base of the animal guessing game
+ *
+ * The database is the same preorder listing print_tree produces: one node per
+ * line, "Q <question>" for questions (followed by its yes and then its no
+ * subtree) and "G <animal>" for guesses. Indentation, empty lines and lines
+ * starting with '#' are ignored when loading, so a printed tree is a valid
+ * database. A database can also be saved compressed (see tree_codec),
+ * load_file tells both formats apart on its own.
+ *
+ * changelog:
+ *  10/19/2026 - initial text format, file helpers
+ *  10/19/2026 - progress counter, the saved file is synced before the rename
+ *  10/19/2026 - compressed format
+ */
+
+#ifndef TREE_IO_HPP
+#define TREE_IO_HPP
+
+#include <atomic>
+#include <fstream>
+#include <string>
+
+#include "animal_node.hpp"
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace tree_io {
+
+    enum Format {
+        TEXT,        // "Q"/"G" lines
+        COMPRESSED   // tree_codec
+    };
+
+    /*
+     *  writes the subtree in the database format, without indentation
+     *  progress (if given) is advanced by the number of nodes written
+     */
+    void save(const animal_node::AnimalNode* root, ostream& output_stream,
+              atomic<size_t>* progress = nullptr);
+
+    /*
+     *  parses a database, returns nullptr if it is malformed
+     */
+    animal_node::AnimalNode* load(istream& input_stream);
+
+    /*
+     *  saves the tree to path, writing a temporary file first and renaming it
+     *  over path so a crash never leaves a half written database
+     */
+    bool save_file(const animal_tree::AnimalTree& tree, const string& path,
+                   atomic<size_t>* progress = nullptr, Format format = TEXT);
+
+    /*
+     *  loads the tree stored at path in either format, returns nullptr on failure
+     */
+    animal_node::AnimalNode* load_file(const string& path);
+
+    /*
+     *  Debug routines
+     */
+    namespace debug {
+        void loaded(const string& path, bool ok);
+    }  // namespace debug
+
+}  // namespace tree_io
+
+#endif  // TREE_IO_HPP
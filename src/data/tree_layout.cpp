@@ -0,0 +1,204 @@
+/*
+ * Tree Layout Implementation
+ * file: tree_layout.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to lay out a tree in memory
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - relayout keeps the hashes
+ *
+ * notes:
+ * - the van Emde Boas order is built on the truncated height of each subtree,
+ *   so it also works for the unbalanced trees the learn-on-miss flow grows.
+ *   Its recursion only nests O(log height) calls deep.
+ */
+
+#include "tree_layout.hpp"
+
+#include <cstdint>
+#include <utility>
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_layout {
+
+    static size_t height_of(const AnimalNode* root) {
+        size_t height = 0;
+        vector<pair<const AnimalNode*, size_t>> pending;
+        if (root) {
+            pending.push_back(make_pair(root, 1));
+        }
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back().first;
+            size_t depth = pending.back().second;
+            pending.pop_back();
+            if (depth > height) {
+                height = depth;
+            }
+            if (node->is_question()) {
+                pending.push_back(make_pair(node->no_branch, depth + 1));
+                pending.push_back(make_pair(node->yes_branch, depth + 1));
+            }
+        }
+        return height;
+    }
+
+    /**
+     * @brief Appends the van Emde Boas order of the first height levels of root.
+     *
+     * The top half of the levels is laid out first, then each subtree hanging
+     * below it, each one recursively in the same way.
+     *
+     * @param root The subtree to be laid out.
+     * @param height Levels of the subtree to be laid out.
+     * @param placed Where the order is appended.
+     */
+    static void van_emde_boas(AnimalNode* root, size_t height, vector<AnimalNode*>& placed) {
+        if (height == 1 || root->is_animal()) {
+            placed.push_back(root);
+            return;
+        }
+        size_t top = (height + 1) / 2;
+        van_emde_boas(root, top, placed);
+
+        // subtrees hanging right below the top levels, yes before no
+        vector<AnimalNode*> frontier;
+        vector<pair<AnimalNode*, size_t>> pending;
+        pending.push_back(make_pair(root, 0));
+        while (!pending.empty()) {
+            AnimalNode* node = pending.back().first;
+            size_t depth = pending.back().second;
+            pending.pop_back();
+            if (depth == top) {
+                frontier.push_back(node);
+            } else if (node->is_question()) {
+                pending.push_back(make_pair(node->no_branch, depth + 1));
+                pending.push_back(make_pair(node->yes_branch, depth + 1));
+            }
+        }
+        for (AnimalNode* subtree : frontier) {
+            van_emde_boas(subtree, height - top, placed);
+        }
+    }
+
+    /**
+     * @brief Preorder where the most visited child always follows its parent.
+     *
+     * @param root The subtree to be laid out.
+     * @param placed Where the order is appended.
+     */
+    static void hot_first(AnimalNode* root, vector<AnimalNode*>& placed) {
+        vector<AnimalNode*> pending;
+        pending.push_back(root);
+        while (!pending.empty()) {
+            AnimalNode* node = pending.back();
+            pending.pop_back();
+            placed.push_back(node);
+            if (node->is_question()) {
+                AnimalNode* hot = node->yes_branch;
+                AnimalNode* cold = node->no_branch;
+                if (cold->visits > hot->visits) {
+                    swap(hot, cold);
+                }
+                pending.push_back(cold);
+                pending.push_back(hot);
+            }
+        }
+    }
+
+    vector<AnimalNode*> order(AnimalNode* root, Layout layout) {
+        vector<AnimalNode*> placed;
+        if (!root) {
+            return placed;
+        }
+        if (layout == VAN_EMDE_BOAS) {
+            van_emde_boas(root, height_of(root), placed);
+        } else {
+            hot_first(root, placed);
+        }
+        return placed;
+    }
+
+    /**
+     * @brief Moves every node of the tree into one block, in layout order.
+     *
+     * Once a node is moved, its old yes_branch is reused to forward to the new
+     * copy, so the branches of the copies are fixed up without a lookup table.
+     * The old nodes are then given back to the pool.
+     *
+     * @param tree The tree to be laid out again.
+     * @param layout The order of the nodes.
+     */
+    void relayout(animal_tree::AnimalTree& tree, Layout layout) {
+        vector<AnimalNode*> placed = order(tree.root, layout);
+        if (placed.empty()) {
+            return;
+        }
+        AnimalNode* block = alloc_block(placed.size());
+
+        for (size_t i = 0; i < placed.size(); i++) {
+            AnimalNode* old = placed[i];
+            block[i].str.swap(old->str);
+            block[i].yes_branch = old->yes_branch;
+            block[i].no_branch = old->no_branch;
+            block[i].visits = old->visits / 2;
+            block[i].hash = old->hash;
+            old->yes_branch = &block[i];
+        }
+        for (size_t i = 0; i < placed.size(); i++) {
+            if (block[i].is_question()) {
+                block[i].yes_branch = block[i].yes_branch->yes_branch;
+                block[i].no_branch = block[i].no_branch->yes_branch;
+            }
+        }
+        for (AnimalNode* old : placed) {
+            free_node(old);
+        }
+        tree.root = block;
+    }
+
+    static uintptr_t line_of(const AnimalNode* node, size_t line_size) {
+        return reinterpret_cast<uintptr_t>(node) / line_size;
+    }
+
+    /**
+     * @brief Average cache lines a walk enters, weighted by how often it's played.
+     *
+     * A line is counted every time the walk moves to a node on a different
+     * line than its parent. Every leaf weighs its visits plus one, so leaves
+     * nobody reached yet still count.
+     */
+    double lines_per_walk(const AnimalNode* root, size_t line_size) {
+        if (!root) {
+            return 0;
+        }
+        double lines = 0;
+        double walks = 0;
+
+        vector<pair<const AnimalNode*, size_t>> pending;
+        pending.push_back(make_pair(root, 1));
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back().first;
+            size_t entered = pending.back().second;
+            pending.pop_back();
+            if (node->is_question()) {
+                const AnimalNode* children[] = {node->yes_branch, node->no_branch};
+                for (const AnimalNode* child : children) {
+                    size_t changed = line_of(child, line_size) != line_of(node, line_size);
+                    pending.push_back(make_pair(child, entered + changed));
+                }
+            } else {
+                double weight = node->visits + 1.0;
+                lines += weight * entered;
+                walks += weight;
+            }
+        }
+        return walks > 0 ? lines / walks : 0;
+    }
+
+}  // namespace tree_layout
@@ -0,0 +1,55 @@
+/*
+ * Tree Layout
+ * file: tree_layout.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * rewrites a tree into one contiguous block of nodes, ordered so a root to
+ * leaf walk touches as few cache lines and pages as possible
+ *
+ * changelog:
+ *  10/19/2026 - van Emde Boas and hot-child-first layouts
+ *
+ * notes:
+ * - every node moves, so pointers to nodes of the tree held elsewhere are no
+ *   longer valid after a relayout. Run it between games (e.g. from the menu
+ *   while nobody plays), it takes a single pass over the tree.
+ * - the hot-child-first order follows AnimalNode::visits, which play_game
+ *   counts. The counters are halved by every relayout so the order keeps
+ *   following recent traffic.
+ */
+
+#ifndef TREE_LAYOUT_HPP
+#define TREE_LAYOUT_HPP
+
+#include <vector>
+
+#include "animal_node.hpp"
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace tree_layout {
+
+    enum Layout {
+        VAN_EMDE_BOAS,  // recursive split at half height, good for any walk
+        HOT_FIRST       // preorder with the most visited child right after its parent
+    };
+
+    // order the nodes of the subtree are placed in by layout
+    vector<animal_node::AnimalNode*> order(animal_node::AnimalNode* root, Layout layout);
+
+    // moves every node of the tree into a new block in the order of layout
+    void relayout(animal_tree::AnimalTree& tree, Layout layout);
+
+    /*
+     *  average number of cache lines (of line_size bytes) a root to leaf walk
+     *  enters, weighted by the visits (plus one) of each leaf
+     */
+    double lines_per_walk(const animal_node::AnimalNode* root, size_t line_size = 64);
+
+}  // namespace tree_layout
+
+#endif  // TREE_LAYOUT_HPP
@@ -0,0 +1,160 @@
+/*
+ * Tree Memory Accounting Implementation
+ * file: tree_memory.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to account the memory of a tree
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - nodes are accounted as pool slots
+ *
+ * notes:
+ */
+
+#include "tree_memory.hpp"
+
+#include <sys/resource.h>
+
+#include <iomanip>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_memory {
+
+    // bookkeeping word glibc keeps in front of every chunk
+    const size_t MALLOC_HEADER = sizeof(size_t);
+
+    static size_t usable_size(const void* block, size_t requested) {
+#ifdef __GLIBC__
+        (void)requested;
+        return malloc_usable_size(const_cast<void*>(block));
+#else
+        (void)block;
+        return requested;
+#endif
+    }
+
+    static size_t header_size() {
+#ifdef __GLIBC__
+        return MALLOC_HEADER;
+#else
+        return 0;
+#endif
+    }
+
+    bool is_inline(const string& str) {
+        const char* data = str.data();
+        const char* object = reinterpret_cast<const char*>(&str);
+        return data >= object && data < object + sizeof(string);
+    }
+
+    /**
+     * @brief Measures the subtree rooted at root.
+     *
+     * Every node is one pool slot of sizeof(AnimalNode) bytes, every string that
+     * doesn't fit in the small string buffer is one malloc block of capacity + 1.
+     * The usable size of each block tells how much the allocator rounded up.
+     *
+     * @param root The subtree to be measured.
+     * @return The footprint of the subtree.
+     */
+    Footprint measure(const AnimalNode* root) {
+        Footprint footprint = Footprint();
+        vector<const AnimalNode*> pending;
+        if (root) {
+            pending.push_back(root);
+        }
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back();
+            pending.pop_back();
+
+            footprint.nodes++;
+            footprint.node_bytes += sizeof(AnimalNode);
+            footprint.allocated_bytes += sizeof(AnimalNode);
+
+            footprint.string_chars += node->str.size();
+            if (is_inline(node->str)) {
+                footprint.inline_strings++;
+            } else {
+                size_t requested = node->str.capacity() + 1;
+                footprint.heap_strings++;
+                footprint.string_heap_bytes += requested;
+                footprint.allocated_bytes += usable_size(node->str.data(), requested);
+                footprint.header_bytes += header_size();
+            }
+
+            if (node->is_question()) {
+                footprint.questions++;
+                pending.push_back(node->yes_branch);
+                pending.push_back(node->no_branch);
+            } else {
+                footprint.animals++;
+            }
+        }
+        footprint.requested_bytes = footprint.node_bytes + footprint.string_heap_bytes;
+        footprint.slack_bytes = footprint.allocated_bytes - footprint.requested_bytes;
+        return footprint;
+    }
+
+    ProcessUsage process_usage() {
+        ProcessUsage usage;
+        usage.live_nodes = live_nodes();
+        usage.peak_live_nodes = peak_live_nodes();
+        PoolStats pool = pool_stats();
+        usage.pool_slabs = pool.slabs;
+        usage.pool_bytes = pool.capacity * sizeof(AnimalNode);
+        usage.pool_free_bytes = pool.free_slots * sizeof(AnimalNode);
+        usage.heap_in_use = 0;
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+        usage.heap_in_use = mallinfo2().uordblks;
+#endif
+        struct rusage resources;
+        getrusage(RUSAGE_SELF, &resources);
+        usage.peak_rss = static_cast<size_t>(resources.ru_maxrss) * 1024;  // kilobytes on linux
+        return usage;
+    }
+
+    static void row(ostream& output_stream, const string& label, size_t value) {
+        output_stream << "  " << left << setw(28) << label << right << setw(16) << value << endl;
+    }
+
+    void print(const Footprint& footprint, ostream& output_stream) {
+        ios::fmtflags flags = output_stream.flags();
+        row(output_stream, "nodes", footprint.nodes);
+        row(output_stream, "  questions", footprint.questions);
+        row(output_stream, "  animals", footprint.animals);
+        row(output_stream, "node bytes", footprint.node_bytes);
+        row(output_stream, "string chars", footprint.string_chars);
+        row(output_stream, "  inline strings", footprint.inline_strings);
+        row(output_stream, "  heap strings", footprint.heap_strings);
+        row(output_stream, "  string heap bytes", footprint.string_heap_bytes);
+        row(output_stream, "requested bytes", footprint.requested_bytes);
+        row(output_stream, "allocated bytes", footprint.allocated_bytes);
+        row(output_stream, "  allocator slack", footprint.slack_bytes);
+        row(output_stream, "  allocator headers", footprint.header_bytes);
+        row(output_stream, "total bytes", footprint.total_bytes());
+        output_stream.flags(flags);
+    }
+
+    void print(const ProcessUsage& usage, ostream& output_stream) {
+        ios::fmtflags flags = output_stream.flags();
+        row(output_stream, "live nodes (all trees)", usage.live_nodes);
+        row(output_stream, "peak live nodes", usage.peak_live_nodes);
+        row(output_stream, "node pool slabs", usage.pool_slabs);
+        row(output_stream, "node pool bytes", usage.pool_bytes);
+        row(output_stream, "  free slot bytes", usage.pool_free_bytes);
+        row(output_stream, "heap in use", usage.heap_in_use);
+        row(output_stream, "peak resident bytes", usage.peak_rss);
+        output_stream.flags(flags);
+    }
+
+}  // namespace tree_memory
@@ -0,0 +1,80 @@
+/*
+ * Tree Memory Accounting
+ * file: tree_memory.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * measures how much memory a tree uses: its nodes, the characters of its
+ * strings (inline in the small string buffer or on the heap) and what the
+ * allocator adds on top of what was requested
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *  10/19/2026 - nodes are accounted as pool slots, pool usage in ProcessUsage
+ *
+ * notes:
+ * - allocator numbers come from malloc_usable_size and mallinfo2 and are only
+ *   available with glibc, elsewhere the allocated bytes equal the requested ones.
+ * - nodes live in the slabs of the node pool, so a node costs exactly its slot.
+ *   Free slots of the pool are shared by every tree and reported per process.
+ */
+
+#ifndef TREE_MEMORY_HPP
+#define TREE_MEMORY_HPP
+
+#include <cstddef>
+#include <iostream>
+
+#include "animal_node.hpp"
+
+using namespace std;
+
+namespace tree_memory {
+
+    struct Footprint {
+        size_t nodes;
+        size_t questions;
+        size_t animals;
+        size_t node_bytes;         // nodes * sizeof(AnimalNode)
+
+        size_t string_chars;       // characters of every str
+        size_t inline_strings;     // strings held in the small string buffer
+        size_t heap_strings;       // strings with a heap buffer
+        size_t string_heap_bytes;  // capacity + 1 of the heap buffers
+
+        size_t requested_bytes;    // node_bytes + string_heap_bytes
+        size_t allocated_bytes;    // usable sizes of every block backing the tree
+        size_t slack_bytes;        // allocated but never requested (rounding)
+        size_t header_bytes;       // per block bookkeeping of the allocator
+
+        // everything the tree costs: allocated blocks and their headers
+        size_t total_bytes() const { return allocated_bytes + header_bytes; }
+    };
+
+    // walks the subtree rooted at root
+    Footprint measure(const animal_node::AnimalNode* root);
+
+    // true if str keeps its characters in the small string buffer
+    bool is_inline(const string& str);
+
+    // process wide numbers
+    struct ProcessUsage {
+        size_t live_nodes;
+        size_t peak_live_nodes;
+        size_t pool_slabs;
+        size_t pool_bytes;     // every slab of the node pool
+        size_t pool_free_bytes;  // slots ready to be reused
+        size_t heap_in_use;    // bytes handed out by malloc, 0 if unknown
+        size_t peak_rss;       // bytes, high water mark of the resident set
+    };
+
+    ProcessUsage process_usage();
+
+    void print(const Footprint& footprint, ostream& output_stream);
+    void print(const ProcessUsage& usage, ostream& output_stream);
+
+}  // namespace tree_memory
+
+#endif  // TREE_MEMORY_HPP
@@ -0,0 +1,281 @@
+/*
+ * Tree Registry Implementation
+ * file: tree_registry.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used for the TreeRegistry structure
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - footprints measured with tree_memory
+ *  10/19/2026 - failed saves keep the tree resident, flush saves unlocked
+ *  10/19/2026 - failed saves are retried after a while, not on every eviction
+ *
+ * notes:
+ * - disk io and footprint walks happen outside the registry lock so lookups of
+ *   other tenants are never stuck behind a slow load or save. Entries that are
+ *   being loaded or evicted make lookups of the same key wait for them.
+ */
+
+#include "tree_registry.hpp"
+
+#include <vector>
+
+#include "metrics.hpp"
+#include "output.hpp"
+#include "tree_io.hpp"
+#include "tree_memory.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_registry {
+
+    bool is_valid_key(const string& key) {
+        if (key.empty() || key == "." || key == "..") {
+            return false;
+        }
+        for (char ch : key) {
+            if (!isalnum(static_cast<unsigned char>(ch)) && ch != '-' && ch != '_' && ch != '.') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    TreeRegistry::TreeRegistry(const string& directory, size_t memory_budget)
+        : directory(directory), budget(memory_budget), bytes_in_use(0) {}
+
+    TreeRegistry::~TreeRegistry() {
+        for (auto& item : entries) {
+            Entry& entry = item.second;
+            if (entry.tree) {
+                if (!tree_io::save_file(*entry.tree, path_of(item.first))) {
+                    output::error("could not save tenant \"" + item.first +
+                                  "\", its lessons since the last save are lost");
+                }
+                free_tree(entry.tree->root);
+                delete entry.tree;
+            }
+        }
+    }
+
+    string TreeRegistry::path_of(const string& key) const {
+        return directory + "/" + key + ".tree";
+    }
+
+    /**
+     * @brief Pins the tree of a tenant, loading it on demand.
+     *
+     * A tenant without a database starts with a new tree. A database that
+     * exists but can't be parsed is left untouched and nullptr is returned, so
+     * a later eviction never overwrites it.
+     *
+     * @param key The tenant key.
+     * @return The pinned tree, nullptr if it can't be provided.
+     */
+    animal_tree::AnimalTree* TreeRegistry::acquire(const string& key) {
+        if (!is_valid_key(key)) {
+            output::error("invalid tenant key \"" + key + "\"");
+            return nullptr;
+        }
+
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            auto found = entries.find(key);
+            if (found == entries.end()) {
+                break;
+            }
+            Entry& entry = found->second;
+            if (entry.state == RESIDENT) {
+                entry.pins++;
+                lru.splice(lru.begin(), lru, entry.lru_position);
+                debug::registry_event("hit", key);
+                return entry.tree;
+            }
+            state_changed.wait(guard);
+        }
+
+        Entry loading;
+        loading.state = LOADING;
+        loading.tree = nullptr;
+        loading.bytes = 0;
+        loading.pins = 0;
+        loading.save_failed_ns = 0;
+        entries[key] = loading;
+        guard.unlock();
+
+        string path = path_of(key);
+        AnimalNode* root = tree_io::load_file(path);
+        if (!root && ifstream(path.c_str())) {
+            guard.lock();
+            entries.erase(key);
+            state_changed.notify_all();
+            output::error("could not load tenant \"" + key + "\"");
+            return nullptr;
+        }
+        animal_tree::AnimalTree* tree =
+            root ? new animal_tree::AnimalTree(root) : new animal_tree::AnimalTree();
+        size_t bytes = tree_memory::measure(tree->root).total_bytes();
+        debug::registry_event(root ? "loaded" : "created", key);
+
+        guard.lock();
+        Entry& entry = entries[key];
+        entry.state = RESIDENT;
+        entry.tree = tree;
+        entry.bytes = bytes;
+        entry.pins = 1;
+        lru.push_front(key);
+        entry.lru_position = lru.begin();
+        bytes_in_use += bytes;
+        state_changed.notify_all();
+
+        evict_if_needed(guard);
+        return tree;
+    }
+
+    /**
+     * @brief Unpins the tree of a tenant and measures it again.
+     *
+     * The tree may have grown while it was pinned, so its footprint is walked
+     * before taking the lock (the pin keeps it alive until then).
+     *
+     * @param key The tenant key.
+     */
+    void TreeRegistry::release(const string& key) {
+        unique_lock<mutex> guard(lock);
+        auto found = entries.find(key);
+        if (found == entries.end() || found->second.state != RESIDENT ||
+            found->second.pins == 0) {
+            output::error("releasing tenant \"" + key + "\" which is not acquired");
+            return;
+        }
+        animal_tree::AnimalTree* tree = found->second.tree;
+        guard.unlock();
+
+        size_t bytes = tree_memory::measure(tree->root).total_bytes();
+
+        guard.lock();
+        Entry& entry = entries[key];
+        bytes_in_use = bytes_in_use - entry.bytes + bytes;
+        entry.bytes = bytes;
+        entry.pins--;
+        evict_if_needed(guard);
+    }
+
+    /**
+     * @brief Saves every resident, unpinned tree.
+     *
+     * Pinned trees may be changing under their owner, so they're skipped.
+     * The others are marked as saving, so lookups of their keys wait and
+     * they're never evicted, and saved with the lock released.
+     */
+    void TreeRegistry::flush() {
+        unique_lock<mutex> guard(lock);
+        vector<pair<string, animal_tree::AnimalTree*>> saving;
+        for (auto& item : entries) {
+            if (item.second.state == RESIDENT && item.second.pins == 0) {
+                item.second.state = SAVING;
+                saving.push_back(make_pair(item.first, item.second.tree));
+            }
+        }
+        guard.unlock();
+
+        vector<uint64_t> failed_ns(saving.size(), 0);
+        for (size_t i = 0; i < saving.size(); i++) {
+            if (tree_io::save_file(*saving[i].second, path_of(saving[i].first))) {
+                debug::registry_event("saved", saving[i].first);
+            } else {
+                output::error("could not save tenant \"" + saving[i].first + "\"");
+                failed_ns[i] = metrics::now_ns();
+            }
+        }
+
+        guard.lock();
+        for (size_t i = 0; i < saving.size(); i++) {
+            Entry& entry = entries[saving[i].first];
+            entry.state = RESIDENT;
+            entry.save_failed_ns = failed_ns[i];
+        }
+        state_changed.notify_all();
+    }
+
+    size_t TreeRegistry::resident_bytes() {
+        lock_guard<mutex> guard(lock);
+        return bytes_in_use;
+    }
+
+    size_t TreeRegistry::resident_count() {
+        lock_guard<mutex> guard(lock);
+        return lru.size();
+    }
+
+    /**
+     * @brief Evicts the coldest unpinned trees until the budget is met.
+     *
+     * The victim is marked as evicting, so lookups of its key wait, and it is
+     * saved and freed with the lock released. A victim that can't be saved
+     * stays resident, so its lessons aren't lost, and isn't picked again
+     * until SAVE_RETRY_MS passed.
+     *
+     * @param guard The held registry lock.
+     */
+    void TreeRegistry::evict_if_needed(unique_lock<mutex>& guard) {
+        while (bytes_in_use > budget) {
+            uint64_t now = metrics::now_ns();
+            auto victim = lru.end();
+            for (auto it = lru.end(); it != lru.begin();) {
+                --it;
+                const Entry& candidate = entries[*it];
+                if (candidate.pins == 0 && candidate.state == RESIDENT &&
+                    (candidate.save_failed_ns == 0 ||
+                     now - candidate.save_failed_ns >= SAVE_RETRY_MS * 1000000)) {
+                    victim = it;
+                    break;
+                }
+            }
+            if (victim == lru.end()) {
+                return;  // every resident tree is pinned, being saved or failed to save
+            }
+
+            string key = *victim;
+            Entry& entry = entries[key];
+            entry.state = EVICTING;
+            lru.erase(victim);
+            bytes_in_use -= entry.bytes;
+            animal_tree::AnimalTree* tree = entry.tree;
+            guard.unlock();
+
+            if (!tree_io::save_file(*tree, path_of(key))) {
+                output::error("could not save tenant \"" + key + "\", keeping it resident");
+                guard.lock();
+                Entry& kept = entries[key];
+                kept.state = RESIDENT;
+                kept.save_failed_ns = metrics::now_ns();
+                lru.push_back(key);
+                kept.lru_position = --lru.end();
+                bytes_in_use += kept.bytes;
+                state_changed.notify_all();
+                continue;
+            }
+            free_tree(tree->root);
+            delete tree;
+            debug::registry_event("evicted", key);
+
+            guard.lock();
+            entries.erase(key);
+            state_changed.notify_all();
+        }
+    }
+
+    namespace debug {
+        void registry_event(const string& event, const string& key) {
+            if (global::debug_flags::REGISTRY) {
+                output::debug("registry " + event + ": ", key);
+            }
+        }
+    }  // namespace debug
+
+}  // namespace tree_registry
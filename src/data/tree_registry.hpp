@@ -0,0 +1,108 @@
+/*
+ * Tree Registry
+ * file: tree_registry.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * owns many knowledge bases (one per tenant key), loads them from disk on
+ * demand and evicts the least recently used ones back to disk whenever the
+ * resident trees exceed the memory budget
+ *
+ * changelog:
+ *  10/19/2026 - initial design, LRU eviction under a memory budget
+ *  10/19/2026 - failed saves keep the tree resident
+ *  10/19/2026 - failed saves are retried after SAVE_RETRY_MS
+ *
+ * notes:
+ * - a tree returned by acquire stays resident (pinned) until it is released,
+ *   so it's never evicted while someone is playing on it. The caller must not
+ *   share one acquired tree between threads without its own locking.
+ * - each tenant is stored as <directory>/<key>.tree in the tree_io format.
+ * - a tree that can't be saved is never freed while the registry lives, so
+ *   the budget may be exceeded until the disk recovers. Eviction passes it
+ *   over for SAVE_RETRY_MS after every failed save, flush tries it anyway.
+ * - the server's --tenants mode plays every game on the tree of the tenant
+ *   the player names, acquired for the length of the game.
+ */
+
+#ifndef TREE_REGISTRY_HPP
+#define TREE_REGISTRY_HPP
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace tree_registry {
+
+    const uint64_t SAVE_RETRY_MS = 10000;  // a tree that failed to save isn't evicted for this long
+
+    struct TreeRegistry {
+        // trees are stored under directory, memory_budget is in bytes
+        TreeRegistry(const string& directory, size_t memory_budget);
+
+        // saves and frees every resident tree
+        ~TreeRegistry();
+
+        // pins the tree of key, loading it (or creating a new one) if needed
+        // returns nullptr if the key is not a valid file name
+        animal_tree::AnimalTree* acquire(const string& key);
+
+        // unpins the tree of key, its footprint is measured again here
+        void release(const string& key);
+
+        // saves every resident, unpinned tree without evicting it
+        void flush();
+
+        size_t resident_bytes();
+        size_t resident_count();
+        size_t memory_budget() const { return budget; }
+
+    private:
+        enum State { LOADING, RESIDENT, SAVING, EVICTING };
+
+        struct Entry {
+            State state;
+            animal_tree::AnimalTree* tree;
+            size_t bytes;
+            int pins;
+            uint64_t save_failed_ns;  // metrics::now_ns of the last failed save, 0 if none
+            list<string>::iterator lru_position;
+        };
+
+        string directory;
+        size_t budget;
+        size_t bytes_in_use;
+
+        mutex lock;
+        condition_variable state_changed;
+        unordered_map<string, Entry> entries;
+        list<string> lru;  // most recently used first, resident entries only
+
+        TreeRegistry(const TreeRegistry&);
+        TreeRegistry& operator=(const TreeRegistry&);
+
+        string path_of(const string& key) const;
+        void evict_if_needed(unique_lock<mutex>& guard);
+    };
+
+    // true if key only uses letters, digits, '-', '_' and '.' (and isn't . or ..)
+    bool is_valid_key(const string& key);
+
+    /*
+     *  Debug routines
+     */
+    namespace debug {
+        void registry_event(const string& event, const string& key);
+    }  // namespace debug
+
+}  // namespace tree_registry
+
+#endif  // TREE_REGISTRY_HPP
@@ -0,0 +1,105 @@
+/*
+ * Background Tree Saver Implementation
+ * file: tree_saver.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used for the AsyncSaver structure
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *
+ * notes:
+ */
+
+#include "tree_saver.hpp"
+
+#include <vector>
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_saver {
+
+    AsyncSaver::AsyncSaver()
+        : busy(false), succeeded(false), written(0), total(0), target_format(tree_io::TEXT) {}
+
+    AsyncSaver::~AsyncSaver() {
+        wait();
+    }
+
+    /**
+     * @brief Snapshots the tree and starts writing it on a background thread.
+     *
+     * @param tree The live tree, it can keep changing once this returns.
+     * @param path The database file to be replaced.
+     * @param format Format of the database written.
+     * @return False if a previous save is still running.
+     */
+    bool AsyncSaver::start(const animal_tree::AnimalTree& tree, const string& path,
+                           tree_io::Format format) {
+        if (busy.load()) {
+            return false;
+        }
+        if (worker.joinable()) {
+            worker.join();  // previous save finished but was never polled
+        }
+
+        AnimalNode* snapshot = clone_tree(tree.root);
+        target_path = path;
+        target_format = format;
+        written.store(0);
+        total.store(0);
+        succeeded.store(false);
+        busy.store(true);
+        worker = thread(&AsyncSaver::write_snapshot, this, snapshot);
+        return true;
+    }
+
+    Status AsyncSaver::poll() {
+        if (busy.load()) {
+            return RUNNING;
+        }
+        if (worker.joinable()) {
+            worker.join();
+            return succeeded.load() ? DONE : FAILED;
+        }
+        return IDLE;
+    }
+
+    void AsyncSaver::wait() {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Body of the background thread, owns and frees the snapshot.
+     *
+     * @param snapshot The deep copy taken by start.
+     */
+    void AsyncSaver::write_snapshot(AnimalNode* snapshot) {
+        size_t nodes = 0;
+        vector<const AnimalNode*> pending;
+        if (snapshot) {
+            pending.push_back(snapshot);
+        }
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back();
+            pending.pop_back();
+            nodes++;
+            if (node->is_question()) {
+                pending.push_back(node->yes_branch);
+                pending.push_back(node->no_branch);
+            }
+        }
+        total.store(nodes);
+
+        succeeded.store(tree_io::save_file(animal_tree::AnimalTree(snapshot), target_path, &written,
+                                           target_format));
+        free_tree(snapshot);
+        busy.store(false);
+    }
+
+}  // namespace tree_saver
@@ -0,0 +1,84 @@
+/*
+ * Background Tree Saver
+ * file: tree_saver.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * saves a snapshot of the tree on a background thread so the game loop keeps
+ * running (and learning) while a large tree is written
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *  10/19/2026 - format of the saved database
+ *
+ * notes:
+ * - the snapshot is a deep copy taken on the caller's thread when the save
+ *   starts, lessons learned afterwards land only in the live tree.
+ * - the file is written through tree_io::save_file, so the database on disk
+ *   is replaced atomically once the snapshot is completely written.
+ */
+
+#ifndef TREE_SAVER_HPP
+#define TREE_SAVER_HPP
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "animal_tree.hpp"
+#include "tree_io.hpp"
+
+using namespace std;
+
+namespace tree_saver {
+
+    enum Status {
+        IDLE,     // nothing saved since the last report
+        RUNNING,  // a snapshot is being written
+        DONE,     // the last save completed
+        FAILED    // the last save failed, the previous database is untouched
+    };
+
+    struct AsyncSaver {
+        AsyncSaver();
+
+        // waits for a running save
+        ~AsyncSaver();
+
+        // snapshots tree and starts writing it to path
+        // returns false if a save is already running
+        bool start(const animal_tree::AnimalTree& tree, const string& path,
+                   tree_io::Format format = tree_io::TEXT);
+
+        // state of the save, DONE and FAILED are reported once and then the
+        // saver goes back to IDLE
+        Status poll();
+
+        // blocks until the running save (if any) finishes
+        void wait();
+
+        bool running() const { return busy.load(); }
+        size_t nodes_written() const { return written.load(); }
+        size_t nodes_total() const { return total.load(); }
+        const string& path() const { return target_path; }
+
+    private:
+        thread worker;
+        atomic<bool> busy;
+        atomic<bool> succeeded;
+        atomic<size_t> written;
+        atomic<size_t> total;
+        string target_path;
+        tree_io::Format target_format;
+
+        AsyncSaver(const AsyncSaver&);
+        AsyncSaver& operator=(const AsyncSaver&);
+
+        void write_snapshot(animal_node::AnimalNode* snapshot);
+    };
+
+}  // namespace tree_saver
+
+#endif  // TREE_SAVER_HPP
@@ -0,0 +1,106 @@
+/*
+ * Tree Traversal
+ * file: tree_traversal.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * walks many independent queries from the root to their animal, e.g. the
+ * answers of a batch of simulated players, without waiting on memory for
+ * each branch one query at a time
+ *
+ * changelog:
+ *  10/19/2026 - initial design, one at a time and interleaved walks
+ *
+ * notes:
+ * - on a tree larger than the last level cache almost every branch followed
+ *   is a cache miss, and a single walk can't start the next load before the
+ *   current node arrives. walk_interleaved keeps a group of queries in flight:
+ *   each step moves one query down one branch and prefetches the node it
+ *   lands on, which is only read when the query's turn comes again, after
+ *   the other queries of the group took theirs. A finished query hands its
+ *   slot to the next one, so the group stays full until the queries run out.
+ * - answer(query, node) is called once per question on the path, it should
+ *   only read the node (reading the text costs one more miss per step).
+ * - the walks are templates so answer is inlined into the loop.
+ */
+
+#ifndef TREE_TRAVERSAL_HPP
+#define TREE_TRAVERSAL_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "animal_node.hpp"
+
+using namespace std;
+
+namespace tree_traversal {
+
+    const size_t DEFAULT_GROUP = 16;
+
+    /*
+     *  walks query 0 .. count - 1 one after the other, leaves[q] is the animal
+     *  query q ends at. Answer is bool(size_t query, const AnimalNode& question)
+     */
+    template <typename Answer>
+    void walk_each(const animal_node::AnimalNode* root, size_t count, Answer answer,
+                   const animal_node::AnimalNode** leaves) {
+        for (size_t q = 0; q < count; q++) {
+            const animal_node::AnimalNode* node = root;
+            while (node->is_question()) {
+                node = answer(q, *node) ? node->yes_branch : node->no_branch;
+            }
+            leaves[q] = node;
+        }
+    }
+
+    /*
+     *  same result as walk_each, with group queries walked in lockstep
+     */
+    template <typename Answer>
+    void walk_interleaved(const animal_node::AnimalNode* root, size_t count, Answer answer,
+                          const animal_node::AnimalNode** leaves,
+                          size_t group = DEFAULT_GROUP) {
+        struct Slot {
+            size_t query;
+            const animal_node::AnimalNode* node;
+        };
+        if (group == 0) {
+            group = 1;
+        }
+        vector<Slot> slots;
+        size_t next_query = 0;
+        while (slots.size() < group && next_query < count) {
+            Slot slot = {next_query++, root};
+            slots.push_back(slot);
+        }
+
+        size_t active = slots.size();
+        while (active > 0) {
+            for (size_t s = 0; s < active;) {
+                Slot& slot = slots[s];
+                const animal_node::AnimalNode* node = slot.node;
+                if (node->is_question()) {
+                    node = answer(slot.query, *node) ? node->yes_branch : node->no_branch;
+                    __builtin_prefetch(node);
+                    slot.node = node;
+                    s++;
+                    continue;
+                }
+                leaves[slot.query] = node;
+                if (next_query < count) {
+                    slot.query = next_query++;
+                    slot.node = root;
+                    s++;
+                } else {
+                    slots[s] = slots[--active];  // the moved slot takes its turn now
+                }
+            }
+        }
+    }
+
+}  // namespace tree_traversal
+
+#endif  // TREE_TRAVERSAL_HPP
@@ -0,0 +1,437 @@
+/*
+ * Line Server Implementation
+ * file: line_server.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to serve line oriented clients
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - several listening sockets, connect, send and ticks
+ *  10/19/2026 - close_after_sent, handlers may connect() from any callback
+ *  10/19/2026 - on_drained once a client's output is sent
+ *
+ * notes:
+ * - epoll is level triggered and a readable client gets one read per wakeup,
+ *   so a client streaming lines can't starve the others.
+ */
+
+#include "line_server.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+
+#include "output.hpp"
+
+using namespace std;
+
+namespace line_server {
+
+    const int MAX_EVENTS = 1024;
+    const size_t READ_CHUNK = 64 * 1024;
+
+    LineServer::LineServer()
+        : epoll_fd(-1), stop_fd(-1), spare_fd(-1), refusing(false), tick_ms(0), open_clients(0) {}
+
+    LineServer::~LineServer() {
+        for (size_t i = 0; i < listen_fds.size(); i++) {
+            close(listen_fds[i]);
+            unlink(paths[i].c_str());
+        }
+        for (size_t fd = 0; fd < by_fd.size(); fd++) {
+            if (by_fd[fd].open) {
+                close(static_cast<int>(fd));
+            }
+        }
+        if (epoll_fd >= 0) {
+            close(epoll_fd);
+        }
+        if (stop_fd >= 0) {
+            close(stop_fd);
+        }
+        if (spare_fd >= 0) {
+            close(spare_fd);
+        }
+    }
+
+    /**
+     * @brief Creates the epoll set, the first time a socket is added.
+     */
+    bool LineServer::set_up() {
+        if (epoll_fd >= 0) {
+            return true;
+        }
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (epoll_fd < 0 || stop_fd < 0) {
+            output::error(string("epoll/eventfd: ") + strerror(errno));
+            return false;
+        }
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = stop_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_fd, &event);
+        return true;
+    }
+
+    static bool address_of(const string& socket_path, sockaddr_un& address) {
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (socket_path.size() >= sizeof(address.sun_path)) {
+            output::error("socket path is too long: " + socket_path);
+            return false;
+        }
+        strcpy(address.sun_path, socket_path.c_str());
+        return true;
+    }
+
+    /**
+     * @brief Binds and listens on a Unix stream socket.
+     *
+     * @param socket_path Where the socket is created, an old one is removed.
+     * @return False (after reporting why) if the socket can't be set up.
+     */
+    bool LineServer::listen(const string& socket_path) {
+        sockaddr_un address;
+        if (!address_of(socket_path, address) || !set_up()) {
+            return false;
+        }
+        int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd < 0) {
+            output::error(string("socket: ") + strerror(errno));
+            return false;
+        }
+        unlink(socket_path.c_str());
+        if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            ::listen(listen_fd, SOMAXCONN) < 0) {
+            output::error("could not listen on " + socket_path + ": " + strerror(errno));
+            close(listen_fd);
+            return false;
+        }
+        listen_fds.push_back(listen_fd);
+        paths.push_back(socket_path);
+
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = listen_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+        return true;
+    }
+
+    /**
+     * @brief Connects to a Unix stream socket and serves the connection as a
+     * client.
+     *
+     * The connection is made blocking and switched to non-blocking after, a
+     * local socket connects right away or not at all.
+     *
+     * @param socket_path The socket to connect to.
+     * @return The client descriptor, -1 if the connection failed.
+     */
+    int LineServer::connect(const string& socket_path) {
+        sockaddr_un address;
+        if (!address_of(socket_path, address) || !set_up()) {
+            return -1;
+        }
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            close(fd);
+            return -1;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        add_client(fd, -1);
+        return fd;
+    }
+
+    int LineServer::listener_of(int client) const {
+        return by_fd[client].listener;
+    }
+
+    void LineServer::send(int client, const string& data) {
+        if (client < 0 || client >= static_cast<int>(by_fd.size()) || !by_fd[client].open) {
+            return;
+        }
+        by_fd[client].out += data;
+        watch(client, true);
+    }
+
+    size_t LineServer::pending(int client) const {
+        return by_fd[client].out.size();
+    }
+
+    void LineServer::disconnect(int client) {
+        if (client < 0 || client >= static_cast<int>(by_fd.size()) || !by_fd[client].open) {
+            return;
+        }
+        by_fd[client].out.clear();
+        by_fd[client].closing = true;
+        watch(client, true);
+    }
+
+    void LineServer::close_after_sent(int client) {
+        if (client < 0 || client >= static_cast<int>(by_fd.size()) || !by_fd[client].open) {
+            return;
+        }
+        by_fd[client].closing = true;
+        watch(client, true);
+    }
+
+    int LineServer::listener_index(int fd) const {
+        for (size_t i = 0; i < listen_fds.size(); i++) {
+            if (listen_fds[i] == fd) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void LineServer::add_client(int fd, int listener) {
+        if (fd >= static_cast<int>(by_fd.size())) {
+            by_fd.resize(fd + 1);
+        }
+        Client& client = by_fd[fd];
+        client.open = true;
+        client.closing = false;
+        client.writing = false;
+        client.listener = listener;
+        client.in.clear();
+        client.out.clear();
+        open_clients++;
+
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    // watches the client for writing while it has pending output, for reading otherwise
+    void LineServer::watch(int fd, bool writing) {
+        Client& client = by_fd[fd];
+        if (writing != client.writing) {
+            epoll_event event;
+            event.events = writing ? EPOLLOUT : EPOLLIN;
+            event.data.fd = fd;
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+            client.writing = writing;
+        }
+    }
+
+    /**
+     * @brief Serves the clients until stop() is called.
+     *
+     * Clients still connected when the loop ends are closed.
+     *
+     * @param handler Reacts to the clients.
+     * @return False if the loop failed.
+     */
+    bool LineServer::run(Handler& handler) {
+        if (epoll_fd < 0) {
+            output::error("the server is not listening");
+            return false;
+        }
+        epoll_event events[MAX_EVENTS];
+        bool stopping = false;
+        bool ok = true;
+        chrono::steady_clock::time_point next_tick =
+            chrono::steady_clock::now() + chrono::milliseconds(tick_ms);
+        while (!stopping) {
+            int timeout = -1;
+            if (tick_ms > 0) {
+                chrono::steady_clock::time_point now = chrono::steady_clock::now();
+                if (now >= next_tick) {
+                    handler.on_tick();
+                    next_tick = now + chrono::milliseconds(tick_ms);
+                }
+                timeout = static_cast<int>(
+                    chrono::duration_cast<chrono::milliseconds>(next_tick - now).count() + 1);
+            }
+            int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                output::error(string("epoll_wait: ") + strerror(errno));
+                ok = false;
+                break;
+            }
+            for (int i = 0; i < ready; i++) {
+                int fd = events[i].data.fd;
+                uint32_t flags = events[i].events;
+                if (fd == stop_fd) {
+                    stopping = true;
+                } else if (listener_index(fd) >= 0) {
+                    accept_clients(fd, handler);
+                } else if (fd < static_cast<int>(by_fd.size()) && by_fd[fd].open) {
+                    if (by_fd[fd].writing) {
+                        if (flags & (EPOLLERR | EPOLLHUP)) {
+                            close_client(fd, handler);
+                        } else {
+                            send_pending(fd, handler);
+                        }
+                    } else {
+                        receive(fd, handler);
+                    }
+                }
+            }
+        }
+
+        for (size_t fd = 0; fd < by_fd.size(); fd++) {
+            if (by_fd[fd].open) {
+                close_client(static_cast<int>(fd), handler);
+            }
+        }
+        uint64_t count;
+        ssize_t drained = read(stop_fd, &count, sizeof(count));
+        (void)drained;
+        return ok;
+    }
+
+    void LineServer::stop() {
+        uint64_t one = 1;
+        ssize_t written = write(stop_fd, &one, sizeof(one));
+        (void)written;
+    }
+
+    void LineServer::accept_clients(int listen_fd, Handler& handler) {
+        while (true) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if ((errno == EMFILE || errno == ENFILE) && spare_fd >= 0) {
+                    if (!refusing) {
+                        output::error("out of file descriptors, turning clients away");
+                        refusing = true;
+                    }
+                    close(spare_fd);
+                    fd = accept(listen_fd, nullptr, nullptr);
+                    if (fd >= 0) {
+                        close(fd);
+                    }
+                    spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+                    continue;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    output::error(string("accept: ") + strerror(errno));
+                }
+                return;
+            }
+            refusing = false;
+            add_client(fd, listener_index(listen_fd));
+            string reply;
+            handler.on_open(fd, reply);
+            by_fd[fd].out += reply;
+            send_pending(fd, handler);
+        }
+    }
+
+    /**
+     * @brief Reads what the client sent and hands every complete line to
+     * the handler.
+     */
+    void LineServer::receive(int fd, Handler& handler) {
+        char buffer[READ_CHUNK];
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received == 0) {
+            close_client(fd, handler);
+            return;
+        }
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                close_client(fd, handler);
+            }
+            return;
+        }
+
+        by_fd[fd].in.append(buffer, received);
+        size_t begin = 0;
+        while (!by_fd[fd].closing) {
+            const string& in = by_fd[fd].in;
+            size_t end = in.find('\n', begin);
+            if (end == string::npos) {
+                break;
+            }
+            size_t length = end - begin;
+            if (length > 0 && in[end - 1] == '\r') {
+                length--;
+            }
+            string reply;
+            bool keep = handler.on_line(fd, in.substr(begin, length), reply);
+            by_fd[fd].out += reply;  // the handler may have connect()ed and moved by_fd
+            if (!keep) {
+                by_fd[fd].closing = true;
+            }
+            begin = end + 1;
+        }
+        Client& client = by_fd[fd];
+        client.in.erase(0, begin);
+        if (client.in.size() > MAX_LINE) {
+            client.out += "line too long\n";
+            client.closing = true;
+        }
+        send_pending(fd, handler);
+    }
+
+    /**
+     * @brief Sends as much of the pending replies as the socket takes.
+     *
+     * While replies are pending the client is only watched for writing.
+     */
+    void LineServer::send_pending(int fd, Handler& handler) {
+        Client& client = by_fd[fd];
+        size_t sent = 0;
+        while (sent < client.out.size()) {
+            ssize_t written =
+                ::send(fd, client.out.data() + sent, client.out.size() - sent, MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    close_client(fd, handler);
+                    return;
+                }
+                break;
+            }
+            sent += written;
+        }
+        client.out.erase(0, sent);
+
+        if (sent > 0 && client.out.empty() && !client.closing) {
+            handler.on_drained(fd);  // may send() more
+        }
+        Client& drained = by_fd[fd];  // the handler may have connect()ed and moved by_fd
+        bool pending = !drained.out.empty();
+        watch(fd, pending);
+        if (!pending && drained.closing) {
+            close_client(fd, handler);
+        }
+    }
+
+    void LineServer::close_client(int fd, Handler& handler) {
+        if (!by_fd[fd].open) {
+            return;
+        }
+        handler.on_close(fd);
+        Client& client = by_fd[fd];
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        client.open = false;
+        client.in = string();
+        client.out = string();
+        open_clients--;
+    }
+
+}  // namespace line_server
@@ -0,0 +1,141 @@
+/*
+ * Line Server
+ * file: line_server.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * single threaded epoll loop serving many clients over a local (Unix) stream
+ * socket, one request line in, any number of reply lines out
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *  10/19/2026 - several listening sockets, outgoing connections, queued
+ *               sends and a periodic tick (see replication)
+ *  10/19/2026 - clients can be closed once their replies are sent (see sharding)
+ *  10/19/2026 - handlers hear when a client's output is drained (see replication)
+ *
+ * notes:
+ * - Linux only (epoll, eventfd, accept4).
+ * - sockets are non-blocking. Replies that don't fit in the socket buffer wait
+ *   in the client's output buffer and the client's lines are not read until
+ *   it is drained, so a slow reader can't make the server buffer without end.
+ * - when the process runs out of descriptors, new clients are accepted and
+ *   closed right away, otherwise the listening socket would stay readable
+ *   and the loop would spin.
+ * - lines end with '\n', a trailing '\r' is dropped. A client sending a line
+ *   longer than MAX_LINE is disconnected.
+ * - send() only queues, the loop sends it. Handlers can call it for any
+ *   client from any callback without being called back in the middle.
+ */
+
+#ifndef LINE_SERVER_HPP
+#define LINE_SERVER_HPP
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace line_server {
+
+    const size_t MAX_LINE = 4096;
+
+    /*
+     * Reacts to the clients of a LineServer. Clients are identified by their
+     * descriptor, which is reused once on_close has been called.
+     */
+    struct Handler {
+        virtual ~Handler() {}
+
+        // a client connected, reply is sent to it
+        virtual void on_open(int client, string& reply) = 0;
+
+        // a line arrived, returns false to disconnect the client after reply
+        virtual bool on_line(int client, const string& line, string& reply) = 0;
+
+        // the client is gone, either side closed it
+        virtual void on_close(int client) = 0;
+
+        // called every tick_every() milliseconds, if set
+        virtual void on_tick() {}
+
+        // everything queued for the client was sent, e.g. to send the next
+        // part of a long reply only once the client reads the last one
+        virtual void on_drained(int client) { (void)client; }
+    };
+
+    struct LineServer {
+        LineServer();
+        ~LineServer();
+
+        // binds the socket, replacing a stale one at path. Can be called again
+        // to serve more sockets, they are numbered in the order they were added
+        bool listen(const string& socket_path);
+
+        // connects to a listening socket, the connection is then served like
+        // any client (on_open is not called). Returns its descriptor, -1 on failure
+        int connect(const string& socket_path);
+
+        // number of the socket client came through, -1 if it was connect()ed
+        int listener_of(int client) const;
+
+        // queues data to be sent to client
+        void send(int client, const string& data);
+
+        // bytes queued for client and not yet taken by its socket
+        size_t pending(int client) const;
+
+        // drops what is queued for client and closes it from the loop
+        void disconnect(int client);
+
+        // closes client from the loop once what is queued for it is sent
+        void close_after_sent(int client);
+
+        void tick_every(int milliseconds) { tick_ms = milliseconds; }
+
+        // serves the clients until stop(), false if the loop failed
+        bool run(Handler& handler);
+
+        // makes run return, safe to call from a signal handler
+        void stop();
+
+        size_t clients() const { return open_clients; }
+
+    private:
+        struct Client {
+            bool open;
+            bool closing;     // disconnect once out is sent
+            bool writing;     // waiting for the socket to take out
+            int listener;     // see listener_of
+            string in;        // received, not yet a full line
+            string out;       // replies not yet sent
+        };
+
+        vector<int> listen_fds;
+        vector<string> paths;
+        int epoll_fd;
+        int stop_fd;
+        int spare_fd;         // given up to turn clients away when out of descriptors
+        bool refusing;
+        int tick_ms;
+        vector<Client> by_fd;
+        size_t open_clients;
+
+        LineServer(const LineServer&);
+        LineServer& operator=(const LineServer&);
+
+        bool set_up();
+        int listener_index(int fd) const;
+        void add_client(int fd, int listener);
+        void watch(int fd, bool writing);
+        void accept_clients(int listen_fd, Handler& handler);
+        void receive(int fd, Handler& handler);
+        void send_pending(int fd, Handler& handler);
+        void close_client(int fd, Handler& handler);
+    };
+
+}  // namespace line_server
+
+#endif  // LINE_SERVER_HPP
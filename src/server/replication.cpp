@@ -0,0 +1,238 @@
+/*
+ * Replication Implementation
+ * file: replication.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to copy a tree to follower servers
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - snapshots are written a chunk at a time
+ *  10/19/2026 - trees kept in animal_tree::TreeGenerations
+ */
+
+#include "replication.hpp"
+
+#include <cstdlib>
+#include <sstream>
+
+#include "lesson_batch.hpp"
+#include "metrics.hpp"
+#include "output.hpp"
+#include "tree_io.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace replication {
+
+    Leader::Leader(line_server::LineServer& server, animal_tree::AnimalTree& tree)
+        : server(server), tree(tree), seq(0), dropped_followers(0) {}
+
+    /**
+     * @brief Starts streaming to a follower with a snapshot of the tree.
+     *
+     * @param client The follower's connection.
+     * @param reply Sent to the follower, the first chunk of the snapshot.
+     */
+    void Leader::add_follower(int client, string& reply) {
+        Stream& stream = streams[client];
+        stream.snapshotting = true;
+        stream.pending.clear();
+        stream.flipped.clear();
+        stream.held.clear();
+        if (tree.root) {
+            stream.pending.push_back(tree.root);
+        }
+        reply += "S " + to_string(seq) + '\n';
+        continue_snapshot(stream, reply);
+    }
+
+    void Leader::remove_follower(int client) {
+        streams.erase(client);
+    }
+
+    void Leader::on_drained(int client) {
+        unordered_map<int, Stream>::iterator stream = streams.find(client);
+        if (stream == streams.end() || !stream->second.snapshotting) {
+            return;
+        }
+        string chunk;
+        continue_snapshot(stream->second, chunk);
+        server.send(client, chunk);
+    }
+
+    /**
+     * @brief Writes the next SNAPSHOT_CHUNK bytes or so of the snapshot, in
+     * the tree_io text format, and the held back flips after its end.
+     *
+     * A leaf flipped since the snapshot began is written as the animal it
+     * was, its flip follows the snapshot. The old animal is the no branch of
+     * the flip, or of the flip of that, and so on.
+     *
+     * @param stream The follower's stream.
+     * @param out Where the chunk is appended.
+     */
+    void Leader::continue_snapshot(Stream& stream, string& out) {
+        size_t limit = out.size() + SNAPSHOT_CHUNK;
+        while (!stream.pending.empty() && out.size() < limit) {
+            const AnimalNode* node = stream.pending.back();
+            stream.pending.pop_back();
+            if (stream.flipped.count(node)) {
+                while (stream.flipped.count(node)) {
+                    node = node->no_branch;
+                }
+                out += "G " + node->str + '\n';
+            } else if (node->is_question()) {
+                out += "Q " + node->str + '\n';
+                stream.pending.push_back(node->no_branch);
+                stream.pending.push_back(node->yes_branch);
+            } else {
+                out += "G " + node->str + '\n';
+            }
+        }
+        if (stream.pending.empty()) {
+            out += "E\n";
+            out += stream.held;
+            stream.snapshotting = false;
+            unordered_set<const AnimalNode*>().swap(stream.flipped);
+            string().swap(stream.held);
+        }
+    }
+
+    /**
+     * @brief Sends the flip to every follower, dropping the ones that fell
+     * more than MAX_LAG_BYTES behind.
+     *
+     * A follower still reading its snapshot gets the flip after it.
+     */
+    void Leader::on_flip(const AnimalNode* question, const string& path) {
+        seq++;
+        lesson_batch::Lesson lesson;
+        lesson.path = path;
+        lesson.animal = question->yes_branch->str;
+        lesson.question = question->str;
+        string line = "F " + to_string(seq) + ' ' + to_string(metrics::now_ns()) + ' ' +
+                      lesson_batch::format_line(lesson) + '\n';
+
+        unordered_map<int, Stream>::iterator follower = streams.begin();
+        while (follower != streams.end()) {
+            Stream& stream = follower->second;
+            if (stream.snapshotting) {
+                stream.flipped.insert(question);
+                stream.held += line;
+            } else {
+                server.send(follower->first, line);
+            }
+            size_t behind = server.pending(follower->first) + stream.held.size();
+            if (behind > MAX_LAG_BYTES) {
+                output::error("follower " + to_string(follower->first) + " is " +
+                              to_string(behind) + " bytes behind, dropping it");
+                server.disconnect(follower->first);
+                dropped_followers++;
+                follower = streams.erase(follower);
+            } else {
+                ++follower;
+            }
+        }
+    }
+
+    Follower::Follower(line_server::LineServer& server, const string& leader_path)
+        : server(server),
+          leader_path(leader_path),
+          leader_fd(-1),
+          applied_seq(0),
+          receiving_snapshot(false),
+          snapshot_seq(0),
+          snapshots_loaded(0) {
+        trees.replace(nullptr);
+    }
+
+    bool Follower::connect() {
+        if (leader_fd >= 0) {
+            return true;
+        }
+        leader_fd = server.connect(leader_path);
+        return leader_fd >= 0;
+    }
+
+    void Follower::on_leader_close() {
+        leader_fd = -1;
+        receiving_snapshot = false;
+        snapshot = string();
+    }
+
+    /**
+     * @brief Applies one line of the leader's stream.
+     *
+     * @param line The line, without its line break.
+     * @return False if the stream can't be followed, the connection is then
+     * dropped and the next one starts from a snapshot.
+     */
+    bool Follower::on_leader_line(const string& line) {
+        if (receiving_snapshot) {
+            if (line != "E") {
+                snapshot += line;
+                snapshot += '\n';
+                return true;
+            }
+            receiving_snapshot = false;
+            istringstream input(snapshot);
+            snapshot = string();
+            AnimalNode* root = tree_io::load(input);
+            if (!root) {
+                output::error("the leader's snapshot is malformed");
+                return false;
+            }
+            trees.replace(root);
+            applied_seq = snapshot_seq;
+            snapshots_loaded++;
+            output::inform("following the leader from flip " + to_string(applied_seq));
+            return true;
+        }
+        if (line.compare(0, 2, "S ") == 0) {
+            receiving_snapshot = true;
+            snapshot_seq = strtoull(line.c_str() + 2, nullptr, 10);
+            return true;
+        }
+        if (line.compare(0, 2, "F ") == 0) {
+            return apply_flip(line);
+        }
+        output::error("unexpected line from the leader: " + line);
+        return false;
+    }
+
+    /**
+     * @brief Applies "F <seq> <ns> <lesson>" to the current tree.
+     */
+    bool Follower::apply_flip(const string& line) {
+        size_t seq_end = line.find(' ', 2);
+        size_t time_end = seq_end == string::npos ? seq_end : line.find(' ', seq_end + 1);
+        lesson_batch::Lesson lesson;
+        if (time_end == string::npos || !lesson_batch::parse_line(line.substr(time_end + 1), lesson)) {
+            output::error("malformed flip from the leader");
+            return false;
+        }
+        uint64_t seq = strtoull(line.c_str() + 2, nullptr, 10);
+        uint64_t made_at = strtoull(line.c_str() + seq_end + 1, nullptr, 10);
+        if (seq != applied_seq + 1) {
+            output::error("flip " + to_string(seq) + " arrived after flip " +
+                          to_string(applied_seq) + ", starting over");
+            return false;
+        }
+        animal_tree::AnimalTree& tree = trees.current();
+        AnimalNode* leaf = tree.leaf_at(lesson.path);
+        if (!leaf) {
+            output::error("flip " + to_string(seq) + " doesn't match the tree, starting over");
+            return false;
+        }
+        tree.learn(leaf, lesson.path, lesson.question, lesson.animal);
+        applied_seq = seq;
+        uint64_t now = metrics::now_ns();
+        metrics::record(metrics::REPLICATION_LAG, now > made_at ? now - made_at : 0);
+        return true;
+    }
+
+}  // namespace replication
@@ -0,0 +1,137 @@
+/*
+ * Replication
+ * file: replication.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * keeps read only copies of the leader's tree in other server processes
+ * (followers), so games can be spread over them
+ *
+ * The leader sends every follower a snapshot when it connects and then one
+ * line per flip, in order:
+ *
+ *   S <seq>                       snapshot of the tree after flip seq,
+ *   Q ... / G ...                 in the tree_io text format,
+ *   E                             until this line
+ *   F <seq> <ns> <lesson>         flip seq, made at <ns> (steady clock) as a
+ *                                 lesson_batch line: path, animal, question
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *  10/19/2026 - snapshots are sent a chunk at a time and count towards the lag
+ *  10/19/2026 - the follower's trees are animal_tree::TreeGenerations
+ *
+ * notes:
+ * - both sides run in the server's loop, they never block it. The leader
+ *   writes a snapshot SNAPSHOT_CHUNK bytes at a time, each once the follower
+ *   read the last one, so neither the loop nor memory holds the whole tree.
+ *   Flips made meanwhile are held back until the snapshot ends, and the
+ *   leaves they flipped are written as they were when it started.
+ * - a follower that is more than MAX_LAG_BYTES behind (unread snapshot and
+ *   flips in its socket, plus flips held back for it) is dropped by the
+ *   leader. It connects again and starts over from a new snapshot, so it is
+ *   never more than that far behind.
+ * - a follower that gets a flip out of order or for a path its tree doesn't
+ *   have also starts over from a snapshot.
+ * - a new snapshot replaces the follower's tree for new games, games already
+ *   running finish on the tree they started on, which is freed after them.
+ * - the time from a flip on the leader to the same flip on a follower is
+ *   recorded as metrics::REPLICATION_LAG (both use the same steady clock).
+ */
+
+#ifndef REPLICATION_HPP
+#define REPLICATION_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "animal_tree.hpp"
+#include "line_server.hpp"
+
+using namespace std;
+
+namespace replication {
+
+    const size_t MAX_LAG_BYTES = 1 << 20;
+    const size_t SNAPSHOT_CHUNK = 64 << 10;
+
+    // sends the flips of tree to followers, install as the tree's observer
+    struct Leader : animal_tree::TreeObserver {
+        Leader(line_server::LineServer& server, animal_tree::AnimalTree& tree);
+
+        // a follower connected, queues the start of its snapshot into reply
+        void add_follower(int client, string& reply);
+        void remove_follower(int client);
+
+        // the follower read what it was sent, its snapshot goes on
+        void on_drained(int client);
+
+        void on_flip(const animal_node::AnimalNode* question, const string& path);
+
+        uint64_t sequence() const { return seq; }
+        size_t followers() const { return streams.size(); }
+        size_t dropped() const { return dropped_followers; }
+
+    private:
+        struct Stream {
+            bool snapshotting;
+            vector<const animal_node::AnimalNode*> pending;          // preorder walk left
+            unordered_set<const animal_node::AnimalNode*> flipped;  // since the snapshot began
+            string held;                                             // flips made meanwhile
+        };
+
+        line_server::LineServer& server;
+        animal_tree::AnimalTree& tree;
+        uint64_t seq;                          // flips so far
+        unordered_map<int, Stream> streams;    // by follower
+        size_t dropped_followers;
+
+        void continue_snapshot(Stream& stream, string& out);
+    };
+
+    // copy of a leader's tree, fed from the leader's connection
+    struct Follower {
+        Follower(line_server::LineServer& server, const string& leader_path);
+
+        // connects to the leader unless connected, false if it can't
+        bool connect();
+
+        bool is_leader(int client) const { return client == leader_fd; }
+
+        // applies a line from the leader, false to drop the connection
+        bool on_leader_line(const string& line);
+
+        void on_leader_close();
+
+        // tree for a new game, release it when the game is over
+        animal_tree::AnimalTree& acquire() { return trees.acquire(); }
+        void release(animal_tree::AnimalTree& tree) { trees.release(tree); }
+
+        uint64_t applied() const { return applied_seq; }
+        size_t snapshots() const { return snapshots_loaded; }
+
+    private:
+        line_server::LineServer& server;
+        string leader_path;
+        int leader_fd;
+        animal_tree::TreeGenerations trees;
+        uint64_t applied_seq;
+        bool receiving_snapshot;
+        string snapshot;
+        uint64_t snapshot_seq;
+        size_t snapshots_loaded;
+
+        Follower(const Follower&);
+        Follower& operator=(const Follower&);
+
+        bool apply_flip(const string& line);
+    };
+
+}  // namespace replication
+
+#endif  // REPLICATION_HPP
@@ -0,0 +1,513 @@
+/*
+ * Animal Guessing Server
+ * file: server_main.cpp
+ * author: Diego R.R.
+ * date: 10/19/2026
+ * course: CS2337.501
+ *
+ * Purpose:
+ * Serves the animal guessing game to many players at once over a local Unix
+ * socket. Every connection plays one game on the shared tree: the server
+ * sends a prompt line, the player answers with a line, until the closing
+ * line of the game, after which the server disconnects.
+ *
+ * Usage:
+ *   server [--socket PATH] [--tree FILE [--watch]] [--replicate PATH | --follow PATH]
+ *          [--max-depth D]
+ *   server --split FILE --shards DIR [--count S] [--depth D]
+ *   server --shards DIR --shard K
+ *   server --shards DIR --route [--socket PATH] [--control PATH]
+ *   server --tenants DIR [--socket PATH] [--budget MB]
+ *
+ *   --socket     socket to listen on (default animal_game.sock)
+ *   --tree       database the tree is loaded from and saved to on SIGINT/SIGTERM
+ *                (default: a new tree that is not saved)
+ *   --watch      new games are played on the newest version of the --tree file,
+ *                reloaded whenever it is replaced, see tree_reload
+ *   --replicate  leader: also listen on PATH for followers and stream every
+ *                lesson to them
+ *   --follow     follower: copy the tree of the leader replicating on PATH and
+ *                serve read only games on it, --tree is ignored
+ *   --max-depth  rebuild the subtrees that take games past D questions, asking
+ *                players for the answers it misses, see depth_watchdog
+ *   --split      cuts the database FILE at depth D (default 4) over S shards
+ *                (default 2), writing them to DIR (created if needed), see sharding
+ *   --shard      serves the cuts of shard K of DIR on DIR/shard-K.sock
+ *   --route      asks the questions above the cuts of DIR and forwards every
+ *                game to the shard of its cut, takes "cuts" and "move <path>
+ *                <shard>" on the control socket (default DIR/control.sock)
+ *   --tenants    serves one tree per tenant from DIR/<key>.tree (DIR is created if
+ *                needed), every connection first sends its tenant key. At most
+ *                --budget MB of trees (default 256) are kept in memory, the least
+ *                recently played are saved and dropped, see tree_registry
+ *
+ *   e.g.  socat - UNIX-CONNECT:animal_game.sock
+ *
+ * Changelog:
+ *  - 10/19/2026 - initial version.
+ *  - 10/19/2026 - leader and follower modes, see replication.
+ *  - 10/19/2026 - the database can be reloaded without a restart.
+ *  - 10/19/2026 - the tree can be split over shard processes behind a router.
+ *  - 10/19/2026 - --max-depth.
+ *  - 10/19/2026 - one tree per tenant.
+ *  - 10/19/2026 - --max-depth reports the lessons the watchdog took back.
+ */
+
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_map>
+
+using namespace std;
+
+#include "animal_tree.hpp"
+#include "depth_watchdog.hpp"
+#include "game_session.hpp"
+#include "line_server.hpp"
+#include "metrics.hpp"
+#include "output.hpp"
+#include "replication.hpp"
+#include "sharding.hpp"
+#include "tree_io.hpp"
+#include "tree_registry.hpp"
+#include "tree_reload.hpp"
+
+line_server::LineServer server;
+
+// listen() order of the server's sockets
+const int GAME_SOCKET = 0;
+const int REPLICA_SOCKET = 1;
+
+// a follower tries to reach its leader again this often
+const int RECONNECT_MS = 1000;
+
+void request_stop(int) {
+    server.stop();
+}
+
+/**
+ * @brief Reads the value of a "--name value" option.
+ *
+ * @return The value, fallback if the option is absent.
+ */
+string option(int argc, char** argv, const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (name == argv[i]) {
+            return argv[i + 1];
+        }
+    }
+    return fallback;
+}
+
+/**
+ * @brief Tells whether the "--name" option was given.
+ */
+bool flag(int argc, char** argv, const string& name) {
+    for (int i = 1; i < argc; i++) {
+        if (name == argv[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// one game session per connected player, and the replication connections
+struct SessionHandler : line_server::Handler {
+    animal_tree::AnimalTree& tree;
+    replication::Leader* leader;      // nullptr unless replicating
+    replication::Follower* follower;  // nullptr unless following, games use its trees
+    tree_reload::ReloadingTree* reloading;  // nullptr unless watching, games use its trees
+    depth_watchdog::Watchdog* watchdog;     // nullptr unless the depth is kept down
+    unordered_map<int, game_session::GameSession> sessions;
+    unordered_map<int, animal_tree::AnimalTree*> tree_of;  // of every session
+    size_t games;
+    size_t learned;
+
+    SessionHandler(animal_tree::AnimalTree& tree, replication::Leader* leader,
+                   replication::Follower* follower, tree_reload::ReloadingTree* reloading,
+                   depth_watchdog::Watchdog* watchdog)
+        : tree(tree), leader(leader), follower(follower), reloading(reloading),
+          watchdog(watchdog), games(0), learned(0) {}
+
+    void on_open(int client, string& reply) {
+        if (leader && server.listener_of(client) == REPLICA_SOCKET) {
+            leader->add_follower(client, reply);
+            return;
+        }
+        animal_tree::AnimalTree& game_tree = follower    ? follower->acquire()
+                                             : reloading ? reloading->acquire()
+                                                         : tree;
+        game_session::GameSession session(game_tree, follower == nullptr, watchdog);
+        reply += session.prompt();
+        reply += '\n';
+        sessions.insert(make_pair(client, session));
+        tree_of[client] = &game_tree;
+    }
+
+    bool on_line(int client, const string& line, string& reply) {
+        if (follower && follower->is_leader(client)) {
+            return follower->on_leader_line(line);
+        }
+        if (leader && server.listener_of(client) == REPLICA_SOCKET) {
+            return true;
+        }
+        game_session::GameSession& session = sessions.find(client)->second;
+        session.feed(line);
+        reply += session.prompt();
+        reply += '\n';
+        if (session.state() != game_session::DONE) {
+            return true;
+        }
+        games++;
+        learned += session.result().learned;
+        return false;
+    }
+
+    void on_close(int client) {
+        if (follower && follower->is_leader(client)) {
+            output::error("lost the leader, serving flip " + to_string(follower->applied()));
+            follower->on_leader_close();
+            return;
+        }
+        if (leader && server.listener_of(client) == REPLICA_SOCKET) {
+            leader->remove_follower(client);
+            return;
+        }
+        if (follower) {
+            follower->release(*tree_of[client]);
+        }
+        if (reloading) {
+            reloading->release(*tree_of[client]);
+        }
+        tree_of.erase(client);
+        sessions.erase(client);
+    }
+
+    void on_tick() {
+        if (follower) {
+            follower->connect();
+        }
+    }
+
+    void on_drained(int client) {
+        if (leader && server.listener_of(client) == REPLICA_SOCKET) {
+            leader->on_drained(client);
+        }
+    }
+};
+
+// one game session per player on the tree of the tenant it named first
+struct TenantHandler : line_server::Handler {
+    struct Player {
+        string key;                          // empty until the first line
+        game_session::GameSession* session;  // on the tenant's tree, pinned meanwhile
+    };
+
+    tree_registry::TreeRegistry& registry;
+    unordered_map<int, Player> players;
+    size_t games;
+    size_t learned;
+
+    explicit TenantHandler(tree_registry::TreeRegistry& registry)
+        : registry(registry), games(0), learned(0) {}
+
+    void on_open(int client, string& reply) {
+        Player player = {"", nullptr};
+        players[client] = player;
+        reply += "Which tree? (tenant key)\n";
+    }
+
+    bool on_line(int client, const string& line, string& reply) {
+        Player& player = players[client];
+        if (!player.session) {
+            // loads happen here, in the event loop, like the shards' takes
+            animal_tree::AnimalTree* tree = registry.acquire(line);
+            if (!tree) {
+                reply += "error: no tree for \"" + line + "\"\n";
+                return false;
+            }
+            player.key = line;
+            player.session = new game_session::GameSession(*tree);
+        } else {
+            player.session->feed(line);
+        }
+        reply += player.session->prompt();
+        reply += '\n';
+        if (player.session->state() != game_session::DONE) {
+            return true;
+        }
+        games++;
+        learned += player.session->result().learned;
+        return false;
+    }
+
+    void on_close(int client) {
+        Player& player = players[client];
+        if (player.session) {
+            delete player.session;
+            registry.release(player.key);
+        }
+        players.erase(client);
+    }
+};
+
+/**
+ * @brief Lets the server hold as many connections as the hard limit allows.
+ */
+void raise_descriptor_limit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+/**
+ * @brief Splits a database into a shards directory.
+ *
+ * @return The exit status.
+ */
+int split_tree(const string& tree_path, const string& directory, int shards, int depth) {
+    animal_node::AnimalNode* root = tree_io::load_file(tree_path);
+    if (!root || depth < 0) {
+        output::error("could not split " + tree_path);
+        animal_node::free_tree(root);
+        return 1;
+    }
+    sharding::SplitReport report;
+    bool ok = sharding::split(root, depth, shards, directory, report);
+    animal_node::free_tree(root);
+    if (!ok) {
+        return 1;
+    }
+    output::inform(to_string(report.cuts) + " cuts written to " + directory);
+    for (size_t shard = 0; shard < report.nodes_of.size(); shard++) {
+        output::inform("shard " + to_string(shard) + ": " + to_string(report.nodes_of[shard]) +
+                       " nodes");
+    }
+    return 0;
+}
+
+/**
+ * @brief Serves one shard of a shards directory until SIGINT/SIGTERM, then
+ * saves it.
+ *
+ * @return The exit status.
+ */
+int serve_shard(const string& directory, int number) {
+    sharding::Shard shard(server, directory, number);
+    if (!shard.load()) {
+        return 1;
+    }
+    string socket_path = sharding::shard_socket(directory, number);
+    raise_descriptor_limit();
+    if (!server.listen(socket_path)) {
+        return 1;
+    }
+    signal(SIGINT, request_stop);
+    signal(SIGTERM, request_stop);
+    output::inform("serving " + to_string(shard.cuts()) + " cuts on " + socket_path);
+
+    bool ok = server.run(shard);
+
+    output::inform(to_string(shard.games()) + " games played, " + to_string(shard.learned()) +
+                   " animals learned");
+    metrics::print(cout);
+    if (shard.save()) {
+        output::inform("shard saved to " + sharding::shard_file(directory, number));
+    }
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Serves the trees of a tenants directory until SIGINT/SIGTERM.
+ *
+ * @return The exit status.
+ */
+int serve_tenants(const string& directory, const string& socket_path, long long budget_mb) {
+    if (budget_mb <= 0) {
+        output::error("--budget must be positive");
+        return 1;
+    }
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        output::error("could not create " + directory);
+        return 1;
+    }
+    raise_descriptor_limit();
+    if (!server.listen(socket_path)) {
+        return 1;
+    }
+    signal(SIGINT, request_stop);
+    signal(SIGTERM, request_stop);
+    output::inform("serving the tenants of " + directory + " on " + socket_path);
+
+    // the registry saves every tree still in memory when it goes
+    tree_registry::TreeRegistry registry(directory, static_cast<size_t>(budget_mb) << 20);
+    TenantHandler handler(registry);
+    bool ok = server.run(handler);
+
+    output::inform(to_string(handler.games) + " games played, " + to_string(handler.learned) +
+                   " animals learned, " + to_string(registry.resident_count()) +
+                   " trees in memory (" + to_string(registry.resident_bytes() >> 10) + " KB)");
+    metrics::print(cout);
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Routes the games of a shards directory until SIGINT/SIGTERM.
+ *
+ * @return The exit status.
+ */
+int serve_router(const string& directory, const string& socket_path,
+                 const string& control_path) {
+    sharding::Router router(server, directory);
+    if (!router.load()) {
+        return 1;
+    }
+    raise_descriptor_limit();
+    if (!server.listen(socket_path) || !server.listen(control_path)) {
+        return 1;
+    }
+    signal(SIGINT, request_stop);
+    signal(SIGTERM, request_stop);
+    output::inform("routing " + directory + " on " + socket_path + ", control on " +
+                   control_path);
+
+    bool ok = server.run(router);
+
+    output::inform(to_string(router.forwarded()) + " games forwarded, " +
+                   to_string(router.moved()) + " cuts moved");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    string shards_path = option(argc, argv, "--shards", "");
+    if (!shards_path.empty()) {
+        string split_path = option(argc, argv, "--split", "");
+        if (!split_path.empty()) {
+            return split_tree(split_path, shards_path,
+                              atoi(option(argc, argv, "--count", "2").c_str()),
+                              atoi(option(argc, argv, "--depth", "4").c_str()));
+        }
+        if (flag(argc, argv, "--route")) {
+            return serve_router(shards_path, option(argc, argv, "--socket", "animal_game.sock"),
+                                option(argc, argv, "--control", shards_path + "/control.sock"));
+        }
+        string number = option(argc, argv, "--shard", "");
+        if (number.empty()) {
+            output::error("--shards needs --split, --shard or --route");
+            return 1;
+        }
+        return serve_shard(shards_path, atoi(number.c_str()));
+    }
+
+    string tenants_path = option(argc, argv, "--tenants", "");
+    if (!tenants_path.empty()) {
+        return serve_tenants(tenants_path, option(argc, argv, "--socket", "animal_game.sock"),
+                             atoll(option(argc, argv, "--budget", "256").c_str()));
+    }
+
+    string socket_path = option(argc, argv, "--socket", "animal_game.sock");
+    string tree_path = option(argc, argv, "--tree", "");
+    string replica_path = option(argc, argv, "--replicate", "");
+    string leader_path = option(argc, argv, "--follow", "");
+    bool watch = flag(argc, argv, "--watch");
+    int max_depth = atoi(option(argc, argv, "--max-depth", "0").c_str());
+    if (!leader_path.empty()) {
+        tree_path.clear();
+        replica_path.clear();
+    }
+    if (watch && (tree_path.empty() || !replica_path.empty())) {
+        output::error("--watch needs --tree and can't be used with --replicate or --follow");
+        return 1;
+    }
+    if (max_depth < 0 || (max_depth > 0 && (watch || !replica_path.empty() ||
+                                            !leader_path.empty()))) {
+        output::error("--max-depth must be positive and can't be used with --watch, --replicate "
+                      "or --follow");
+        return 1;
+    }
+
+    animal_tree::AnimalTree tree(nullptr);
+    if (!tree_path.empty() && access(tree_path.c_str(), F_OK) == 0) {
+        tree.root = tree_io::load_file(tree_path);
+        if (!tree.root) {
+            return 1;
+        }
+    } else {
+        tree = animal_tree::AnimalTree();
+    }
+
+    raise_descriptor_limit();
+    if (!server.listen(socket_path) || (!replica_path.empty() && !server.listen(replica_path))) {
+        return 1;
+    }
+    signal(SIGINT, request_stop);
+    signal(SIGTERM, request_stop);
+    output::inform("serving on " + socket_path);
+
+    replication::Leader leader(server, tree);
+    replication::Follower follower(server, leader_path);
+    if (!replica_path.empty()) {
+        tree.observer = &leader;
+        output::inform("replicating on " + replica_path);
+    }
+    if (!leader_path.empty()) {
+        if (!follower.connect()) {
+            output::error("could not reach the leader at " + leader_path + ", retrying");
+        }
+        server.tick_every(RECONNECT_MS);
+    }
+
+    tree_reload::ReloadingTree reloading;
+    if (watch) {
+        reloading.start(tree_path, tree.root);
+        output::inform("watching " + tree_path);
+    }
+
+    depth_watchdog::Limits limits = {static_cast<size_t>(max_depth),
+                                     depth_watchdog::DEFAULT_IMBALANCE,
+                                     depth_watchdog::DEFAULT_MAX_ANIMALS};
+    depth_watchdog::Watchdog watchdog(tree, limits);
+    if (max_depth > 0) {
+        output::inform(to_string(watchdog.check_all()) + " subtrees rebuilt to keep games within " +
+                       to_string(max_depth) + " questions");
+    }
+
+    SessionHandler handler(tree, replica_path.empty() ? nullptr : &leader,
+                           leader_path.empty() ? nullptr : &follower,
+                           watch ? &reloading : nullptr, max_depth > 0 ? &watchdog : nullptr);
+    bool ok = server.run(handler);
+
+    output::inform(to_string(handler.games) + " games played, " + to_string(handler.learned) +
+                   " animals learned");
+    if (!replica_path.empty()) {
+        output::inform(to_string(leader.sequence()) + " flips replicated, " +
+                       to_string(leader.dropped()) + " lagging followers dropped");
+    }
+    if (!leader_path.empty()) {
+        output::inform("followed the leader up to flip " + to_string(follower.applied()) +
+                       " through " + to_string(follower.snapshots()) + " snapshots");
+    }
+    if (watch) {
+        reloading.stop();
+        output::inform(to_string(reloading.reloads()) + " versions of " + tree_path +
+                       " reloaded, " + to_string(reloading.failures()) + " failed to load");
+    }
+    if (max_depth > 0) {
+        output::inform(to_string(watchdog.restructured()) + " subtrees rebuilt, " +
+                       to_string(watchdog.answers()) + " answers asked for, " +
+                       to_string(watchdog.flagged()) + " subtrees still waiting on answers, " +
+                       to_string(watchdog.taken_back()) + " lessons taken back");
+    }
+    metrics::print(cout);
+    if (!tree_path.empty() && tree_io::save_file(watch ? reloading.current() : tree, tree_path)) {
+        output::inform("tree saved to " + tree_path);
+    }
+    return ok ? 0 : 1;
+}
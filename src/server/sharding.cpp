@@ -0,0 +1,799 @@
+/*
+ * Sharding Implementation
+ * file: sharding.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to serve one tree from several shard processes
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - split creates the shards directory
+ */
+
+#include "sharding.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "global.hpp"
+#include "output.hpp"
+#include "tree_io.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace sharding {
+
+    const string NOT_SERVED = "This part of the tree isn't served here";
+    const string BEING_MOVED = "This part of the tree is being moved, try again soon";
+    const string SHARD_DOWN = "This part of the tree can't be reached, try again soon";
+
+    string map_file(const string& directory) {
+        return directory + "/shards.map";
+    }
+
+    string shard_file(const string& directory, int shard) {
+        return directory + "/shard-" + to_string(shard) + ".tree";
+    }
+
+    string shard_socket(const string& directory, int shard) {
+        return directory + "/shard-" + to_string(shard) + ".sock";
+    }
+
+    static string path_text(const string& path) {
+        return path.empty() ? "-" : path;
+    }
+
+    // reads a path written by path_text, false if it isn't one
+    static bool parse_path(const string& text, string& path) {
+        if (text == "-") {
+            path.clear();
+            return true;
+        }
+        if (text.empty() || text.find_first_not_of("yn") != string::npos) {
+            return false;
+        }
+        path = text;
+        return true;
+    }
+
+    /**
+     * @brief Syncs the temporary file written for path and renames it over
+     * path, like tree_io::save_file.
+     *
+     * @param output_file The temporary file, closed here.
+     * @return False if the file could not be written.
+     */
+    static bool replace_file(ofstream& output_file, const string& tmp_path, const string& path) {
+        output_file.flush();
+        bool written = static_cast<bool>(output_file);
+        output_file.close();
+        if (!written) {
+            output::error("could not write " + tmp_path);
+            remove(tmp_path.c_str());
+            return false;
+        }
+        int fd = open(tmp_path.c_str(), O_RDONLY);
+        if (fd < 0 || fsync(fd) != 0) {
+            output::error("could not sync " + tmp_path);
+            if (fd >= 0) {
+                close(fd);
+            }
+            remove(tmp_path.c_str());
+            return false;
+        }
+        close(fd);
+        if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+            output::error("could not replace " + path);
+            remove(tmp_path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    static size_t count_nodes(const AnimalNode* root) {
+        size_t nodes = 0;
+        vector<const AnimalNode*> pending;
+        if (root) {
+            pending.push_back(root);
+        }
+        while (!pending.empty()) {
+            const AnimalNode* node = pending.back();
+            pending.pop_back();
+            nodes++;
+            if (node->is_question()) {
+                pending.push_back(node->yes_branch);
+                pending.push_back(node->no_branch);
+            }
+        }
+        return nodes;
+    }
+
+    struct SplitCut {
+        const AnimalNode* root;
+        string path;
+        size_t nodes;
+        int shard;
+    };
+
+    struct SplitOpen {
+        const AnimalNode* node;
+        string path;
+    };
+
+    /**
+     * @brief Walks the questions above depth in preorder.
+     *
+     * @param visit Called with every node, true if it's a cut.
+     */
+    template <typename Visit>
+    static void walk_above(const AnimalNode* root, size_t depth, Visit visit) {
+        vector<SplitOpen> pending;
+        SplitOpen first = {root, ""};
+        pending.push_back(first);
+        while (!pending.empty()) {
+            SplitOpen open = pending.back();
+            pending.pop_back();
+            bool cut = !open.node->is_question() || open.path.size() >= depth;
+            visit(open.node, open.path, cut);
+            if (!cut) {
+                SplitOpen no = {open.node->no_branch, open.path + 'n'};
+                SplitOpen yes = {open.node->yes_branch, open.path + 'y'};
+                pending.push_back(no);
+                pending.push_back(yes);
+            }
+        }
+    }
+
+    /**
+     * @brief Cuts the tree, writes the map, then every shard's file.
+     *
+     * The cuts are handed out largest first, each to the shard with the
+     * fewest nodes so far.
+     *
+     * @param root The tree, must not be empty.
+     * @param depth Depth of the cuts, 0 makes the whole tree one cut.
+     * @param shards Number of shards, at least 1.
+     * @param directory Where the files are written, created if missing.
+     * @param report Filled with the cuts and nodes of every shard.
+     * @return False if a file could not be written.
+     */
+    bool split(const AnimalNode* root, size_t depth, int shards, const string& directory,
+               SplitReport& report) {
+        if (!root || shards < 1) {
+            output::error("there is no tree to split, or no shards to split it over");
+            return false;
+        }
+        if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+            output::error("could not create " + directory);
+            return false;
+        }
+
+        vector<SplitCut> cuts;  // in preorder
+        walk_above(root, depth, [&cuts](const AnimalNode* node, const string& path, bool cut) {
+            if (cut) {
+                SplitCut added = {node, path, count_nodes(node), -1};
+                cuts.push_back(added);
+            }
+        });
+
+        vector<size_t> order(cuts.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        stable_sort(order.begin(), order.end(),
+                    [&cuts](size_t a, size_t b) { return cuts[a].nodes > cuts[b].nodes; });
+        report.cuts = cuts.size();
+        report.nodes_of.assign(shards, 0);
+        for (size_t i : order) {
+            int lightest = static_cast<int>(
+                min_element(report.nodes_of.begin(), report.nodes_of.end()) -
+                report.nodes_of.begin());
+            cuts[i].shard = lightest;
+            report.nodes_of[lightest] += cuts[i].nodes;
+        }
+
+        string tmp_path = map_file(directory) + ".tmp";
+        ofstream map_output(tmp_path.c_str());
+        if (!map_output) {
+            output::error("could not open " + tmp_path);
+            return false;
+        }
+        map_output << "shards " << shards << '\n';
+        size_t next_cut = 0;
+        walk_above(root, depth,
+                   [&](const AnimalNode* node, const string&, bool cut) {
+                       if (cut) {
+                           map_output << "C " << cuts[next_cut++].shard << '\n';
+                       } else {
+                           map_output << "Q " << node->str << '\n';
+                       }
+                   });
+        if (!replace_file(map_output, tmp_path, map_file(directory))) {
+            return false;
+        }
+
+        for (int shard = 0; shard < shards; shard++) {
+            string path = shard_file(directory, shard);
+            ofstream shard_output((path + ".tmp").c_str());
+            if (!shard_output) {
+                output::error("could not open " + path + ".tmp");
+                return false;
+            }
+            for (const SplitCut& cut : cuts) {
+                if (cut.shard == shard) {
+                    shard_output << "@ " << path_text(cut.path) << '\n';
+                    tree_io::save(cut.root, shard_output);
+                }
+            }
+            if (!replace_file(shard_output, path + ".tmp", path)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Shard::Shard(line_server::LineServer& server, const string& directory, int number)
+        : server(server), directory(directory), number(number), games_played(0),
+          animals_learned(0) {}
+
+    Shard::~Shard() {
+        for (pair<const int, Connection>& connection : connections) {
+            delete connection.second.session;
+        }
+        for (pair<const string, Cut>& cut : owned) {
+            delete cut.second.tree;
+        }
+    }
+
+    /**
+     * @brief Reads the shard's file, a missing file is a shard without cuts.
+     *
+     * @return False if the file is malformed.
+     */
+    bool Shard::load() {
+        string path = shard_file(directory, number);
+        ifstream input_file(path.c_str());
+        if (!input_file) {
+            return true;
+        }
+        string line;
+        while (getline(input_file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            string cut_path;
+            if (line.compare(0, 2, "@ ") != 0 || !parse_path(line.substr(2), cut_path)) {
+                output::error(path + ": expected \"@ <path>\", got \"" + line + "\"");
+                return false;
+            }
+            AnimalNode* root = tree_io::load(input_file);
+            if (!root) {
+                output::error(path + ": the cut at " + path_text(cut_path) + " is malformed");
+                return false;
+            }
+            Cut cut = {new animal_tree::AnimalTree(root), 0, -1};
+            owned[cut_path] = cut;
+        }
+        return true;
+    }
+
+    bool Shard::save() const {
+        string path = shard_file(directory, number);
+        ofstream output_file((path + ".tmp").c_str());
+        if (!output_file) {
+            output::error("could not open " + path + ".tmp");
+            return false;
+        }
+        for (const pair<const string, Cut>& cut : owned) {
+            output_file << "@ " << path_text(cut.first) << '\n';
+            tree_io::save(cut.second.tree->root, output_file);
+        }
+        return replace_file(output_file, path + ".tmp", path);
+    }
+
+    void Shard::on_open(int client, string&) {
+        Connection connection = {NEW, "", nullptr, ""};
+        connections[client] = connection;
+    }
+
+    bool Shard::on_line(int client, const string& line, string& reply) {
+        Connection& connection = connections[client];
+        switch (connection.kind) {
+            case NEW:
+                return start(client, line, reply);
+            case GAME: {
+                game_session::GameSession& session = *connection.session;
+                session.feed(line);
+                reply += session.prompt();
+                reply += '\n';
+                if (session.state() != game_session::DONE) {
+                    return true;
+                }
+                games_played++;
+                animals_learned += session.result().learned;
+                return false;
+            }
+            case GIVING:
+                return true;
+            case TAKING:
+                if (line != "E") {
+                    connection.text += line;
+                    connection.text += '\n';
+                    return true;
+                }
+                take(connection, reply);
+                return false;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Handles the first line of a connection: a game, a give or a take.
+     *
+     * @return False if the connection is done with.
+     */
+    bool Shard::start(int client, const string& line, string& reply) {
+        Connection& connection = connections[client];
+        size_t space = line.find(' ');
+        string command = line.substr(0, space);
+        string path;
+        if (space == string::npos || !parse_path(line.substr(space + 1), path)) {
+            reply += "error expected @, give or take and a path\n";
+            return false;
+        }
+        map<string, Cut>::iterator cut = owned.find(path);
+
+        if (command == "@") {
+            if (cut == owned.end() || cut->second.giving >= 0) {
+                reply += NOT_SERVED + '\n';
+                return false;
+            }
+            connection.kind = GAME;
+            connection.path = path;
+            connection.session = new game_session::GameSession(*cut->second.tree);
+            cut->second.games++;
+            reply += connection.session->prompt();
+            reply += '\n';
+            return connection.session->state() != game_session::DONE;
+        }
+        if (command == "give") {
+            if (cut == owned.end() || cut->second.giving >= 0) {
+                reply += "error " + path_text(path) + " isn't here to give\n";
+                return false;
+            }
+            connection.kind = GIVING;
+            connection.path = path;
+            cut->second.giving = client;
+            if (cut->second.games > 0) {
+                return true;  // given when its last game closes
+            }
+            give(path, reply);
+            return false;
+        }
+        if (command == "take") {
+            if (cut != owned.end()) {
+                reply += "error " + path_text(path) + " is already here\n";
+                return false;
+            }
+            connection.kind = TAKING;
+            connection.path = path;
+            return true;
+        }
+        reply += "error unknown command " + command + '\n';
+        return false;
+    }
+
+    /**
+     * @brief Writes the cut to reply and drops it from the shard.
+     */
+    void Shard::give(const string& path, string& reply) {
+        map<string, Cut>::iterator cut = owned.find(path);
+        ostringstream lines;
+        tree_io::save(cut->second.tree->root, lines);
+        lines << "E\n";
+        reply += lines.str();
+        delete cut->second.tree;
+        owned.erase(cut);
+        save();
+        output::inform("gave " + path_text(path));
+    }
+
+    /**
+     * @brief Adds the cut the connection sent.
+     */
+    void Shard::take(const Connection& connection, string& reply) {
+        istringstream lines(connection.text);
+        AnimalNode* root = tree_io::load(lines);
+        if (!root) {
+            reply += "error the cut is malformed\n";
+            return;
+        }
+        if (owned.count(connection.path)) {
+            free_tree(root);
+            reply += "error " + path_text(connection.path) + " is already here\n";
+            return;
+        }
+        Cut cut = {new animal_tree::AnimalTree(root), 0, -1};
+        owned[connection.path] = cut;
+        save();
+        reply += "ok\n";
+        output::inform("took " + path_text(connection.path));
+    }
+
+    void Shard::on_close(int client) {
+        Connection connection = connections[client];
+        connections.erase(client);
+        map<string, Cut>::iterator cut = owned.find(connection.path);
+        if (cut == owned.end()) {
+            delete connection.session;
+            return;
+        }
+        if (connection.kind == GAME) {
+            delete connection.session;
+            cut->second.games--;
+            int giving = cut->second.giving;
+            if (giving >= 0 && cut->second.games == 0) {
+                string lines;
+                give(connection.path, lines);
+                server.send(giving, lines);
+                server.close_after_sent(giving);
+            }
+        } else if (connection.kind == GIVING && cut->second.giving == client) {
+            cut->second.giving = -1;  // the router gave up before it was given
+        }
+    }
+
+    Router::Router(line_server::LineServer& server, const string& directory)
+        : server(server), directory(directory), shards(0), top(nullptr), games_forwarded(0),
+          cuts_moved(0) {}
+
+    Router::~Router() {
+        free_tree(top);
+    }
+
+    /**
+     * @brief Reads the map: the shard count and the questions above the cuts.
+     *
+     * @return False if the map is missing or malformed.
+     */
+    bool Router::load() {
+        string path = map_file(directory);
+        ifstream input_file(path.c_str());
+        if (!input_file) {
+            output::error("could not open " + path);
+            return false;
+        }
+        string line;
+        while (getline(input_file, line) && (line.empty() || line[0] == '#')) {
+        }
+        if (line.compare(0, 7, "shards ") != 0 || atoi(line.c_str() + 7) < 1) {
+            output::error(path + ": expected \"shards <count>\"");
+            return false;
+        }
+        shards = atoi(line.c_str() + 7);
+
+        struct Slot {
+            AnimalNode** node;
+            string path;
+        };
+        vector<Slot> slots;
+        Slot first = {&top, ""};
+        slots.push_back(first);
+        while (!slots.empty() && getline(input_file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            Slot slot = slots.back();
+            slots.pop_back();
+            if (line.compare(0, 2, "Q ") == 0) {
+                *slot.node = alloc_animal(line.substr(2));
+                Slot no = {&(*slot.node)->no_branch, slot.path + 'n'};
+                Slot yes = {&(*slot.node)->yes_branch, slot.path + 'y'};
+                slots.push_back(no);
+                slots.push_back(yes);
+                continue;
+            }
+            int shard = atoi(line.c_str() + 2);
+            if (line.compare(0, 2, "C ") != 0 || shard < 0 || shard >= shards) {
+                output::error(path + ": malformed line \"" + line + "\"");
+                return false;
+            }
+            *slot.node = alloc_animal("");
+            owner[slot.path] = shard;
+        }
+        if (!slots.empty()) {
+            output::error(path + " ended before the tree was complete");
+            return false;
+        }
+        return true;
+    }
+
+    bool Router::save() const {
+        string path = map_file(directory);
+        ofstream output_file((path + ".tmp").c_str());
+        if (!output_file) {
+            output::error("could not open " + path + ".tmp");
+            return false;
+        }
+        output_file << "shards " << shards << '\n';
+        struct Open {
+            const AnimalNode* node;
+            string path;
+        };
+        vector<Open> pending;
+        Open first = {top, ""};
+        pending.push_back(first);
+        while (!pending.empty()) {
+            Open open = pending.back();
+            pending.pop_back();
+            if (!open.node->is_question()) {
+                output_file << "C " << owner.find(open.path)->second << '\n';
+                continue;
+            }
+            output_file << "Q " << open.node->str << '\n';
+            Open no = {open.node->no_branch, open.path + 'n'};
+            Open yes = {open.node->yes_branch, open.path + 'y'};
+            pending.push_back(no);
+            pending.push_back(yes);
+        }
+        return replace_file(output_file, path + ".tmp", path);
+    }
+
+    void Router::on_open(int client, string& reply) {
+        if (server.listener_of(client) == CONTROL_SOCKET) {
+            return;
+        }
+        Walk walk = {top, "", -1};
+        Walk& added = walks[client] = walk;
+        if (!enter(client, added, reply)) {
+            server.close_after_sent(client);
+        }
+    }
+
+    /**
+     * @brief Asks the walk's question, or forwards the player to the shard
+     * of the cut the walk reached.
+     *
+     * @return False if the player can't go on, reply says why.
+     */
+    bool Router::enter(int client, Walk& walk, string& reply) {
+        if (walk.node->is_question()) {
+            walk.node->visits++;
+            reply += walk.node->str;
+            reply += '\n';
+            return true;
+        }
+        if (moving.count(walk.path)) {
+            reply += BEING_MOVED + '\n';
+            return false;
+        }
+        int shard_fd = server.connect(shard_socket(directory, owner[walk.path]));
+        if (shard_fd < 0) {
+            reply += SHARD_DOWN + '\n';
+            return false;
+        }
+        walk.shard_fd = shard_fd;
+        player_of[shard_fd] = client;
+        server.send(shard_fd, "@ " + path_text(walk.path) + '\n');
+        games_forwarded++;
+        return true;
+    }
+
+    bool Router::on_line(int client, const string& line, string& reply) {
+        unordered_map<int, int>::iterator player = player_of.find(client);
+        if (player != player_of.end()) {
+            server.send(player->second, line + '\n');
+            return true;
+        }
+        if (moves.count(client)) {
+            on_move_line(client, line);
+            return true;
+        }
+        if (server.listener_of(client) == CONTROL_SOCKET) {
+            return control(client, line, reply);
+        }
+        Walk& walk = walks[client];
+        if (walk.shard_fd >= 0) {
+            server.send(walk.shard_fd, line + '\n');
+            return true;
+        }
+        bool yes = global::fncs::contains(line, "y");
+        walk.path += yes ? 'y' : 'n';
+        walk.node = yes ? walk.node->yes_branch : walk.node->no_branch;
+        return enter(client, walk, reply);
+    }
+
+    void Router::on_close(int client) {
+        unordered_map<int, int>::iterator player = player_of.find(client);
+        if (player != player_of.end()) {
+            // the shard ended the game, the player leaves once it has read the end
+            walks[player->second].shard_fd = -1;
+            server.close_after_sent(player->second);
+            player_of.erase(player);
+            return;
+        }
+        if (moves.count(client)) {
+            on_move_close(client);
+            return;
+        }
+        if (server.listener_of(client) == CONTROL_SOCKET) {
+            for (pair<const int, Move>& move : moves) {
+                if (move.second.control == client) {
+                    move.second.control = -1;
+                }
+            }
+            return;
+        }
+        unordered_map<int, Walk>::iterator walk = walks.find(client);
+        if (walk == walks.end()) {
+            return;
+        }
+        if (walk->second.shard_fd >= 0) {
+            player_of.erase(walk->second.shard_fd);
+            server.disconnect(walk->second.shard_fd);
+        }
+        walks.erase(walk);
+    }
+
+    /**
+     * @brief Runs a command of the control socket.
+     *
+     * @return Always true, the control client leaves when it wants to.
+     */
+    bool Router::control(int client, const string& line, string& reply) {
+        istringstream words(line);
+        string command;
+        words >> command;
+        if (command == "cuts") {
+            map<string, int> sorted(owner.begin(), owner.end());
+            for (const pair<const string, int>& cut : sorted) {
+                reply += path_text(cut.first) + ' ' + to_string(cut.second) +
+                         (moving.count(cut.first) ? " (moving)" : "") + '\n';
+            }
+            reply += to_string(sorted.size()) + " cuts over " + to_string(shards) + " shards\n";
+            return true;
+        }
+        if (command != "move") {
+            reply += "commands: cuts, move <path> <shard>\n";
+            return true;
+        }
+
+        string text;
+        string path;
+        int to = -1;
+        words >> text >> to;
+        unordered_map<string, int>::iterator cut = owner.end();
+        if (parse_path(text, path)) {
+            cut = owner.find(path);
+        }
+        if (cut == owner.end() || to < 0 || to >= shards) {
+            reply += "error expected move <path of a cut> <shard below " + to_string(shards) +
+                     ">\n";
+            return true;
+        }
+        if (cut->second == to || moving.count(path)) {
+            reply += "error " + path_text(path) + " is already on shard " + to_string(to) +
+                     " or being moved\n";
+            return true;
+        }
+        int shard_fd = server.connect(shard_socket(directory, cut->second));
+        if (shard_fd < 0) {
+            reply += "error shard " + to_string(cut->second) + " can't be reached\n";
+            return true;
+        }
+        Move move = {GIVING, path, cut->second, to, client, "", false, ""};
+        moves[shard_fd] = move;
+        moving.insert(path);
+        server.send(shard_fd, "give " + path_text(path) + '\n');
+        reply += "moving " + path_text(path) + " from shard " + to_string(cut->second) +
+                 " to shard " + to_string(to) + ", waiting for its games\n";
+        return true;
+    }
+
+    void Router::on_move_line(int fd, const string& line) {
+        Move& move = moves[fd];
+        if (move.stage == GIVING && line == "E") {
+            move.done = true;
+        } else if (move.stage == GIVING && line.compare(0, 6, "error ") != 0) {
+            move.text += line;
+            move.text += '\n';
+        } else if (line == "ok") {
+            move.done = true;
+        } else {
+            move.error = line;
+        }
+    }
+
+    /**
+     * @brief Takes the move to its next stage when a shard is done with it.
+     *
+     * The given cut goes to the new shard. If that shard doesn't take it,
+     * it goes back to the old one, and if neither takes it, to a file.
+     */
+    void Router::on_move_close(int fd) {
+        Move move = moves[fd];
+        moves.erase(fd);
+        if (move.stage == GIVING && !move.done) {
+            moving.erase(move.path);
+            report(move, "not moved, shard " + to_string(move.from) + " didn't give it" +
+                             (move.error.empty() ? "" : ": " + move.error));
+            return;
+        }
+        if (move.stage == GIVING) {
+            if (!send_cut(move, TAKING, move.to) && !send_cut(move, RETURNING, move.from)) {
+                rescue(move);
+            }
+            return;
+        }
+        if (move.stage == TAKING && move.done) {
+            moving.erase(move.path);
+            owner[move.path] = move.to;
+            cuts_moved++;
+            save();
+            report(move, "moved " + path_text(move.path) + " to shard " + to_string(move.to));
+            return;
+        }
+        if (move.stage == TAKING) {
+            if (!send_cut(move, RETURNING, move.from)) {
+                rescue(move);
+            }
+            return;
+        }
+        if (!move.done) {
+            rescue(move);
+            return;
+        }
+        moving.erase(move.path);
+        report(move, "not moved, shard " + to_string(move.to) + " didn't take it" +
+                         (move.error.empty() ? "" : ": " + move.error) +
+                         ", it is back on shard " + to_string(move.from));
+    }
+
+    /**
+     * @brief Sends the given cut to a shard to take.
+     *
+     * @return False if the shard can't be reached.
+     */
+    bool Router::send_cut(Move move, Stage stage, int shard) {
+        int shard_fd = server.connect(shard_socket(directory, shard));
+        if (shard_fd < 0) {
+            return false;
+        }
+        move.stage = stage;
+        move.done = false;
+        moves[shard_fd] = move;
+        server.send(shard_fd, "take " + path_text(move.path) + '\n' + move.text + "E\n");
+        return true;
+    }
+
+    void Router::report(const Move& move, const string& outcome) {
+        output::inform(outcome);
+        if (move.control >= 0) {
+            server.send(move.control, outcome + '\n');
+        }
+    }
+
+    /**
+     * @brief Keeps a cut no shard took in a file, its games stay turned away
+     * until it is put back by hand.
+     */
+    void Router::rescue(const Move& move) {
+        string path = directory + "/rescued-" + path_text(move.path) + ".tree";
+        ofstream output_file(path.c_str());
+        output_file << move.text;
+        output::error("no shard took " + path_text(move.path) + ", it was written to " + path);
+        report(move, "lost " + path_text(move.path) + ", see " + path);
+    }
+
+}  // namespace sharding
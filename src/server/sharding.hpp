@@ -0,0 +1,198 @@
+/*
+ * Sharding
+ * file: sharding.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * spreads one tree over several server processes (shards) so a tree larger
+ * than one process can hold is still served, with a router process in front
+ * of them asking the questions above the shards
+ *
+ * The tree is cut at a depth: every node at that depth, and every animal
+ * above it, is the root of a cut owned by one shard. A shards directory holds
+ *
+ *   shards.map      shards <count>, then the questions above the cuts in the
+ *                   tree_io format with "C <shard>" in place of every cut
+ *   shard-<k>.tree  "@ <path>" and the cut's subtree in the tree_io format,
+ *                   for every cut of shard k ("-" is the root)
+ *   shard-<k>.sock  socket shard k listens on
+ *
+ * The router walks a player down to a cut and then connects to the cut's
+ * shard for the rest of the game, copying lines both ways. Lines a shard
+ * takes on a new connection:
+ *
+ *   @ <path>                  plays a game on the cut at path
+ *   give <path>               sends the cut as tree_io lines and "E", and
+ *                             drops it, once the games on it are over
+ *   take <path>, lines, E     adds the cut, answers "ok" or "error ..."
+ *
+ * The router's control socket takes "cuts" (the shard of every cut) and
+ * "move <path> <shard>" (rebalancing: the cut is given by its shard and
+ * taken by the other one).
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *  10/19/2026 - split creates the shards directory
+ *
+ * notes:
+ * - learning never leaves a shard: a flip only changes the animal it
+ *   turns into a question, which is inside the cut the game was forwarded
+ *   to. A cut that is a single animal is flipped in place, the router's
+ *   questions never change.
+ * - while a cut moves the router turns away the games that reach it. Its
+ *   shard waits for the games already on it before giving it, so nothing
+ *   they learn is lost.
+ * - shards save their file on exit and after every give and take, the
+ *   router saves the map after every move.
+ */
+
+#ifndef SHARDING_HPP
+#define SHARDING_HPP
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "animal_tree.hpp"
+#include "game_session.hpp"
+#include "line_server.hpp"
+
+using namespace std;
+
+namespace sharding {
+
+    // listen() order of the router's sockets
+    const int GAME_SOCKET = 0;
+    const int CONTROL_SOCKET = 1;
+
+    string map_file(const string& directory);
+    string shard_file(const string& directory, int shard);
+    string shard_socket(const string& directory, int shard);
+
+    struct SplitReport {
+        size_t cuts;
+        vector<size_t> nodes_of;  // nodes of every shard
+    };
+
+    // writes the shards directory (created if missing) for root cut at depth
+    // over shards shards, the cuts are spread so the shards get about as many
+    // nodes each
+    bool split(const animal_node::AnimalNode* root, size_t depth, int shards,
+               const string& directory, SplitReport& report);
+
+    // serves the cuts of one shard
+    struct Shard : line_server::Handler {
+        Shard(line_server::LineServer& server, const string& directory, int number);
+
+        // saves nothing, see save
+        ~Shard();
+
+        bool load();
+        bool save() const;
+
+        void on_open(int client, string& reply);
+        bool on_line(int client, const string& line, string& reply);
+        void on_close(int client);
+
+        size_t cuts() const { return owned.size(); }
+        size_t games() const { return games_played; }
+        size_t learned() const { return animals_learned; }
+
+    private:
+        struct Cut {
+            animal_tree::AnimalTree* tree;
+            size_t games;   // being played on it
+            int giving;     // connection waiting for it, -1 if none
+        };
+
+        enum Kind { NEW, GAME, GIVING, TAKING };
+
+        struct Connection {
+            Kind kind;
+            string path;                         // cut played on, given or taken
+            game_session::GameSession* session;  // GAME
+            string text;                         // TAKING
+        };
+
+        line_server::LineServer& server;
+        string directory;
+        int number;
+        map<string, Cut> owned;
+        unordered_map<int, Connection> connections;
+        size_t games_played;
+        size_t animals_learned;
+
+        Shard(const Shard&);
+        Shard& operator=(const Shard&);
+
+        bool start(int client, const string& line, string& reply);
+        void give(const string& path, string& reply);
+        void take(const Connection& connection, string& reply);
+    };
+
+    // walks players down to their cut and hands them to its shard
+    struct Router : line_server::Handler {
+        Router(line_server::LineServer& server, const string& directory);
+        ~Router();
+
+        bool load();
+        bool save() const;
+
+        void on_open(int client, string& reply);
+        bool on_line(int client, const string& line, string& reply);
+        void on_close(int client);
+
+        size_t forwarded() const { return games_forwarded; }
+        size_t moved() const { return cuts_moved; }
+
+    private:
+        struct Walk {
+            animal_node::AnimalNode* node;  // question asked, or the cut reached
+            string path;
+            int shard_fd;                   // -1 until forwarded
+        };
+
+        enum Stage { GIVING, TAKING, RETURNING };
+
+        struct Move {
+            Stage stage;
+            string path;
+            int from;
+            int to;
+            int control;   // who asked for it, -1 once gone
+            string text;   // the cut, once given
+            bool done;     // the shard answered in full
+            string error;  // what the shard answered instead
+        };
+
+        line_server::LineServer& server;
+        string directory;
+        int shards;
+        animal_node::AnimalNode* top;            // questions above the cuts, cuts are animals
+        unordered_map<string, int> owner;        // shard of every cut, by path
+        unordered_map<int, Walk> walks;          // by player
+        unordered_map<int, int> player_of;       // by shard connection
+        unordered_map<int, Move> moves;          // by shard connection
+        unordered_set<string> moving;            // paths of the cuts being moved
+        size_t games_forwarded;
+        size_t cuts_moved;
+
+        Router(const Router&);
+        Router& operator=(const Router&);
+
+        bool enter(int client, Walk& walk, string& reply);
+        bool control(int client, const string& line, string& reply);
+        void on_move_line(int fd, const string& line);
+        void on_move_close(int fd);
+        bool send_cut(Move move, Stage stage, int shard);
+        void report(const Move& move, const string& outcome);
+        void rescue(const Move& move);
+    };
+
+}  // namespace sharding
+
+#endif  // SHARDING_HPP
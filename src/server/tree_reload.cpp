@@ -0,0 +1,175 @@
+/*
+ * Tree Reload Implementation
+ * file: tree_reload.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used to swap in new versions of the served database
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - versions kept in animal_tree::TreeGenerations
+ */
+
+#include "tree_reload.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "output.hpp"
+#include "tree_io.hpp"
+
+using namespace std;
+using namespace animal_node;
+
+namespace tree_reload {
+
+    ReloadingTree::ReloadingTree()
+        : swapped(0), notify_fd(-1), ready(nullptr), failed_loads(0) {
+        wake_pipe[0] = -1;
+        wake_pipe[1] = -1;
+    }
+
+    ReloadingTree::~ReloadingTree() {
+        stop();
+        free_tree(ready);
+    }
+
+    /**
+     * @brief Serves root and starts loading the new versions of path in the
+     * background.
+     *
+     * The directory is watched rather than the file, replacing the database
+     * through a rename gives the path a new inode the old watch wouldn't see.
+     *
+     * @param path The database file root was loaded from.
+     * @param root The version served until the file changes.
+     * @return False if the file can't be watched.
+     */
+    bool ReloadingTree::start(const string& path, AnimalNode* root) {
+        this->path = path;
+        trees.replace(root);
+
+        size_t slash = path.find_last_of('/');
+        string directory = slash == string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        notify_fd = inotify_init1(IN_CLOEXEC);
+        if (notify_fd < 0 || inotify_add_watch(notify_fd, directory.c_str(),
+                                               IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            output::error("could not watch " + directory);
+            stop();
+            return false;
+        }
+        if (pipe(wake_pipe) != 0) {
+            output::error("could not create the reload wake pipe");
+            stop();
+            return false;
+        }
+        loader = thread(&ReloadingTree::watch, this);
+        return true;
+    }
+
+    void ReloadingTree::stop() {
+        if (loader.joinable()) {
+            char wake = 0;
+            if (write(wake_pipe[1], &wake, 1) == 1) {
+                loader.join();
+            } else {
+                loader.detach();  // never happens with an open pipe
+            }
+        }
+        for (int* fd : {&notify_fd, &wake_pipe[0], &wake_pipe[1]}) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+
+    /**
+     * @brief Loader thread, loads the file every time it settles after a
+     * change. A version loaded before the previous one was swapped in
+     * replaces it.
+     */
+    void ReloadingTree::watch() {
+        while (wait_for_change()) {
+            AnimalNode* root = tree_io::load_file(path);
+            if (!root) {
+                failed_loads++;
+                continue;
+            }
+            AnimalNode* superseded;
+            {
+                lock_guard<mutex> guard(ready_lock);
+                superseded = ready;
+                ready = root;
+            }
+            free_tree(superseded);
+        }
+    }
+
+    /**
+     * @brief Blocks until the file was written or replaced and then left
+     * alone for SETTLE_MS.
+     *
+     * @return False once stop wakes the loader up.
+     */
+    bool ReloadingTree::wait_for_change() {
+        size_t slash = path.find_last_of('/');
+        string name = slash == string::npos ? path : path.substr(slash + 1);
+        bool changed = false;
+
+        pollfd fds[2] = {{notify_fd, POLLIN, 0}, {wake_pipe[0], POLLIN, 0}};
+        while (true) {
+            int ready_fds = poll(fds, 2, changed ? SETTLE_MS : -1);
+            if (ready_fds < 0) {
+                continue;  // EINTR
+            }
+            if (fds[1].revents) {
+                return false;
+            }
+            if (ready_fds == 0) {
+                return true;  // settled
+            }
+
+            char buffer[4096] __attribute__((aligned(__alignof__(inotify_event))));
+            ssize_t length = read(notify_fd, buffer, sizeof(buffer));
+            for (ssize_t offset = 0; offset < length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                if (event->len && name == event->name) {
+                    changed = true;
+                }
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+
+    animal_tree::AnimalTree& ReloadingTree::acquire() {
+        swap_in_ready();
+        return trees.acquire();
+    }
+
+    animal_tree::AnimalTree& ReloadingTree::current() {
+        swap_in_ready();
+        return trees.current();
+    }
+
+    // makes the version the loader handed over the current tree
+    void ReloadingTree::swap_in_ready() {
+        AnimalNode* root;
+        {
+            lock_guard<mutex> guard(ready_lock);
+            root = ready;
+            ready = nullptr;
+        }
+        if (!root) {
+            return;
+        }
+        trees.replace(root);
+        swapped++;
+        output::inform("reloaded " + path + " (version " + to_string(swapped) + ")");
+    }
+
+}  // namespace tree_reload
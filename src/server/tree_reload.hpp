@@ -0,0 +1,94 @@
+/*
+ * Tree Reload
+ * file: tree_reload.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * serves the tree of a database file and picks up new versions of the file
+ * while the server keeps running, so a new knowledge base is deployed by
+ * replacing the file instead of restarting the server
+ *
+ * changelog:
+ *  10/19/2026 - initial design
+ *  10/19/2026 - versions kept in animal_tree::TreeGenerations
+ *
+ * notes:
+ * - the directory of the file is watched with inotify, a background thread
+ *   loads every new version once the file stops changing for SETTLE_MS. The
+ *   database is expected to be replaced whole (tree_io::save_file renames
+ *   over it), a file loaded while half written fails to parse and the
+ *   served version is kept until the next change.
+ * - a loaded version replaces the tree for new games, games already running
+ *   finish on the version they started on, which is freed after them. The
+ *   swap happens on the thread calling acquire, the loader only hands the
+ *   loaded root over.
+ * - animals learned on a version that was replaced are lost with it.
+ */
+
+#ifndef TREE_RELOAD_HPP
+#define TREE_RELOAD_HPP
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace tree_reload {
+
+    const int SETTLE_MS = 200;
+
+    struct ReloadingTree {
+        ReloadingTree();
+
+        // stops watching, the versions are freed with trees
+        ~ReloadingTree();
+
+        // serves root (which it now owns) and starts watching path
+        // false if path can't be watched, root is served anyway
+        bool start(const string& path, animal_node::AnimalNode* root);
+
+        // stops the watcher, the served version stays
+        void stop();
+
+        // tree for a new game, the newest loaded version, release it when the
+        // game is over
+        animal_tree::AnimalTree& acquire();
+        void release(animal_tree::AnimalTree& tree) { trees.release(tree); }
+
+        // version new games get, after swapping in a loaded one
+        animal_tree::AnimalTree& current();
+
+        size_t reloads() const { return swapped; }
+        size_t versions() const { return trees.versions(); }  // still in use
+        size_t failures() const { return failed_loads.load(); }
+
+    private:
+        string path;
+        animal_tree::TreeGenerations trees;
+        size_t swapped;
+
+        // shared with the loader thread
+        thread loader;
+        int notify_fd;
+        int wake_pipe[2];
+        mutex ready_lock;
+        animal_node::AnimalNode* ready;  // newest loaded version, not swapped in yet
+        atomic<size_t> failed_loads;
+
+        ReloadingTree(const ReloadingTree&);
+        ReloadingTree& operator=(const ReloadingTree&);
+
+        void watch();
+        bool wait_for_change();
+        void swap_in_ready();
+    };
+
+}  // namespace tree_reload
+
+#endif  // TREE_RELOAD_HPP
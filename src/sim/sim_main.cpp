@@ -0,0 +1,82 @@
+/*
+ * Animal Guessing Simulation
+ * file: sim_main.cpp
+ * author: Diego R.R.
+ * date: 10/19/2026
+ * course: CS2337.501
+ *
+ * Purpose:
+ * Plays many games against oracle players to measure the engine throughput,
+ * the questions asked per game and how the trees grow while they learn.
+ *
+ * Usage:
+ *   sim [--games N] [--threads T] [--animals A] [--traits M] [--report K] [--seed S]
+ *       [--max-depth D]
+ *
+ *   --games    games per worker thread (default 100000)
+ *   --threads  worker threads, each one grows its own tree (default: hardware threads)
+ *   --animals  animals in the catalog (default 10000)
+ *   --traits   yes/no traits per animal (default 64)
+ *   --report   games between tree growth samples (default games / 10)
+ *   --seed     seed of the catalog and the players (default 1)
+ *   --max-depth   keep every tree within D questions with a depth_watchdog
+ *                 (default 0, no watchdog)
+ *
+ * Changelog:
+ *  - 10/19/2026 - initial version.
+ *  - 10/19/2026 - --max-depth.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+#include "output.hpp"
+#include "simulation.hpp"
+
+/**
+ * @brief Reads the integer value of a "--name value" option.
+ *
+ * @return The parsed value, fallback if the option is absent.
+ */
+long long option(int argc, char** argv, const string& name, long long fallback) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (name == argv[i]) {
+            return atoll(argv[i + 1]);
+        }
+    }
+    return fallback;
+}
+
+int main(int argc, char** argv) {
+    simulation::Options opts;
+    opts.games = option(argc, argv, "--games", 100000);
+    opts.threads = static_cast<int>(option(argc, argv, "--threads", thread::hardware_concurrency()));
+    opts.report_every = static_cast<int>(option(argc, argv, "--report", opts.games / 10));
+    opts.seed = static_cast<uint64_t>(option(argc, argv, "--seed", 1));
+    opts.max_depth = static_cast<int>(option(argc, argv, "--max-depth", 0));
+    int animals = static_cast<int>(option(argc, argv, "--animals", 10000));
+    int traits = static_cast<int>(option(argc, argv, "--traits", 64));
+
+    if (opts.games < 1 || opts.threads < 1 || animals < 1 || traits < 1 || opts.max_depth < 0) {
+        output::error("games, threads, animals and traits must be positive, max depth can't "
+                      "be negative");
+        return 1;
+    }
+    if (opts.report_every < 1) {
+        opts.report_every = 1;
+    }
+
+    output::inform("building catalog of " + to_string(animals) + " animals");
+    simulation::Catalog catalog = simulation::random_catalog(animals, traits, opts.seed);
+
+    output::inform("playing " + to_string(opts.games) + " games on " + to_string(opts.threads) +
+                   " threads");
+    simulation::Report report = simulation::run(catalog, opts);
+    output::separate();
+    simulation::print_report(report, cout);
+
+    return 0;
+}
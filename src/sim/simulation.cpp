@@ -0,0 +1,340 @@
+/*
+ * Simulated Players Implementation
+ * file: simulation.cpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * implementations used for the simulation harness
+ *
+ * changelog:
+ *  10/19/2026 - initial implementation
+ *  10/19/2026 - depth watchdog, the max depth is measured on the tree
+ *  10/19/2026 - the hashes are verified at every sample and after rebuilds
+ *  10/19/2026 - lessons taken back by the watchdog are reported
+ *
+ * notes:
+ * - questions per game are kept in a histogram indexed by the number of
+ *   questions, so millions of games take constant memory.
+ */
+
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include <unordered_set>
+
+#include "depth_watchdog.hpp"
+#include "output.hpp"
+
+using namespace std;
+
+namespace simulation {
+
+    bool Catalog::has(int animal, int trait) const {
+        return (bits[animal * words + trait / 64] >> (trait % 64)) & 1;
+    }
+
+    string Catalog::question(int trait, bool presence) {
+        return string(presence ? "Does it have" : "Does it lack") + " trait #" + to_string(trait) +
+               "?";
+    }
+
+    /**
+     * @brief Builds a catalog of animals with random, pairwise distinct traits.
+     *
+     * @param animals Number of animals, animal 0 is the "lizard" every new tree guesses.
+     * @param traits Number of traits, raised if it can't tell the animals apart.
+     * @param seed Seed of the generator.
+     * @return The catalog.
+     */
+    Catalog random_catalog(int animals, int traits, uint64_t seed) {
+        int needed = 1;
+        while (needed < 63 && (1LL << needed) < animals) {
+            needed++;
+        }
+        if (traits < needed) {
+            output::error("not enough traits to tell the animals apart, using " +
+                          to_string(needed));
+            traits = needed;
+        }
+
+        Catalog catalog;
+        catalog.traits = traits;
+        catalog.words = (traits + 63) / 64;
+        catalog.bits.assign(static_cast<size_t>(animals) * catalog.words, 0);
+
+        mt19937_64 rng(seed);
+        unordered_set<string> seen;
+        for (int a = 0; a < animals; a++) {
+            uint64_t* row = &catalog.bits[static_cast<size_t>(a) * catalog.words];
+            do {
+                for (int w = 0; w < catalog.words; w++) {
+                    row[w] = rng();
+                }
+                if (traits % 64) {
+                    row[catalog.words - 1] &= (1ULL << (traits % 64)) - 1;
+                }
+            } while (!seen.insert(string(reinterpret_cast<char*>(row),
+                                         catalog.words * sizeof(uint64_t)))
+                          .second);
+
+            string name = a == 0 ? "lizard" : "animal " + to_string(a);
+            catalog.animal_index[name] = a;
+            catalog.animals.push_back(name);
+        }
+
+        for (int t = 0; t < traits; t++) {
+            catalog.question_index[Catalog::question(t, true)] = make_pair(t, true);
+            catalog.question_index[Catalog::question(t, false)] = make_pair(t, false);
+        }
+        return catalog;
+    }
+
+    OraclePlayer::OraclePlayer(const Catalog& catalog, int target, mt19937_64& rng)
+        : catalog(catalog), target(target), rng(rng) {}
+
+    bool OraclePlayer::answer(const string& question) {
+        auto found = catalog.question_index.find(question);
+        if (found == catalog.question_index.end()) {
+            output::error_nonexpected("oracle doesn't know \"" + question + "\"");
+            return false;
+        }
+        return catalog.has(target, found->second.first) == found->second.second;
+    }
+
+    bool OraclePlayer::confirm_guess(const string& animal) {
+        return animal == catalog.animals[target];
+    }
+
+    /**
+     * @brief Teaches a trait that tells the target apart from the wrong guess.
+     *
+     * The search for a differing trait starts at a random word so the taught
+     * questions vary like they would with real players.
+     */
+    bool OraclePlayer::teach(const string& guessed, string& animal, string& question) {
+        auto found = catalog.animal_index.find(guessed);
+        if (found == catalog.animal_index.end()) {
+            return false;
+        }
+        const uint64_t* mine = &catalog.bits[static_cast<size_t>(target) * catalog.words];
+        const uint64_t* theirs = &catalog.bits[static_cast<size_t>(found->second) * catalog.words];
+
+        int start = static_cast<int>(rng() % catalog.words);
+        for (int i = 0; i < catalog.words; i++) {
+            int w = (start + i) % catalog.words;
+            uint64_t diff = mine[w] ^ theirs[w];
+            if (diff) {
+                int trait = w * 64 + __builtin_ctzll(diff);
+                animal = catalog.animals[target];
+                question = Catalog::question(trait, catalog.has(target, trait));
+                return true;
+            }
+        }
+        return false;  // same traits, can't be taught
+    }
+
+    // results of one worker thread
+    struct Worker {
+        vector<long long> questions;  // games by number of questions asked
+        vector<GrowthSample> growth;
+        long long guessed;
+        long long learned;
+        long long restructured;
+        long long surveyed;
+        long long taken_back;
+    };
+
+    // questions on the longest path
+    static int tree_height(const animal_node::AnimalNode* root) {
+        int height = 0;
+        vector<pair<const animal_node::AnimalNode*, int>> pending;
+        pending.push_back(make_pair(root, 0));
+        while (!pending.empty()) {
+            const animal_node::AnimalNode* node = pending.back().first;
+            int depth = pending.back().second;
+            pending.pop_back();
+            if (node->is_question()) {
+                pending.push_back(make_pair(node->yes_branch, depth + 1));
+                pending.push_back(make_pair(node->no_branch, depth + 1));
+            } else {
+                height = max(height, depth);
+            }
+        }
+        return height;
+    }
+
+    static void play_worker(const Catalog& catalog, const Options& opts, int id, Worker& worker) {
+        mt19937_64 rng(opts.seed + 1 + id);
+        uniform_int_distribution<int> pick(0, static_cast<int>(catalog.animals.size()) - 1);
+        animal_tree::AnimalTree tree;
+        depth_watchdog::Limits limits = {static_cast<size_t>(opts.max_depth),
+                                         depth_watchdog::DEFAULT_IMBALANCE,
+                                         depth_watchdog::DEFAULT_MAX_ANIMALS};
+        depth_watchdog::Watchdog watchdog(tree, limits);
+
+        long long nodes = 1;
+        long long sample_questions = 0;
+        worker.guessed = 0;
+        worker.learned = 0;
+
+        for (long long g = 1; g <= opts.games; g++) {
+            OraclePlayer player(catalog, pick(rng), rng);
+            animal_tree::GameResult result = tree.play_game(player);
+            if (opts.max_depth > 0) {
+                string question;
+                string animal = result.guessed ? tree.leaf_at(result.path)->str : "";
+                if (result.guessed && watchdog.question_for(animal, question)) {
+                    watchdog.record(animal, question, player.answer(question));
+                }
+                size_t restructured = watchdog.restructured();
+                size_t taken_back = watchdog.taken_back();
+                watchdog.after_game(result);
+                if (watchdog.restructured() != restructured) {
+                    animal_node::debug::verify_hashes(tree.root, "a watchdog rebuild");
+                }
+                if (watchdog.taken_back() != taken_back) {
+                    nodes -= 2;  // the lesson counted below was taken back
+                }
+            }
+
+            if (result.questions >= static_cast<int>(worker.questions.size())) {
+                worker.questions.resize(result.questions + 1, 0);
+            }
+            worker.questions[result.questions]++;
+            sample_questions += result.questions;
+            worker.guessed += result.guessed;
+            if (result.learned) {
+                worker.learned++;
+                nodes += 2;
+            }
+
+            if (g % opts.report_every == 0 || g == opts.games) {
+                long long since = g % opts.report_every ? g % opts.report_every : opts.report_every;
+                GrowthSample sample;
+                sample.games = g;
+                sample.nodes = nodes;
+                sample.max_depth = tree_height(tree.root);
+                animal_node::debug::verify_hashes(tree.root, "learning");
+                sample.avg_questions = static_cast<double>(sample_questions) / since;
+                worker.growth.push_back(sample);
+                sample_questions = 0;
+            }
+        }
+        worker.restructured = static_cast<long long>(watchdog.restructured());
+        worker.surveyed = static_cast<long long>(watchdog.answers());
+        worker.taken_back = static_cast<long long>(watchdog.taken_back());
+        animal_node::free_tree(tree.root);
+    }
+
+    static int percentile(const vector<long long>& histogram, long long total, double p) {
+        long long rank = static_cast<long long>(p * total);
+        long long seen = 0;
+        for (size_t q = 0; q < histogram.size(); q++) {
+            seen += histogram[q];
+            if (seen > rank) {
+                return static_cast<int>(q);
+            }
+        }
+        return histogram.empty() ? 0 : static_cast<int>(histogram.size()) - 1;
+    }
+
+    /**
+     * @brief Plays the simulation and aggregates the workers' results.
+     *
+     * @param catalog Ground truth shared (read only) by every worker.
+     * @param opts How many games and threads.
+     * @return Throughput, questions per game and tree growth.
+     */
+    Report run(const Catalog& catalog, const Options& opts) {
+        vector<Worker> workers(opts.threads);
+        vector<thread> threads;
+
+        auto start = chrono::steady_clock::now();
+        for (int id = 0; id < opts.threads; id++) {
+            threads.push_back(thread(play_worker, cref(catalog), cref(opts), id, ref(workers[id])));
+        }
+        for (thread& t : threads) {
+            t.join();
+        }
+        auto end = chrono::steady_clock::now();
+
+        Report report;
+        report.games = opts.games * opts.threads;
+        report.seconds = chrono::duration<double>(end - start).count();
+        report.guessed = 0;
+        report.learned = 0;
+        report.restructured = 0;
+        report.surveyed = 0;
+        report.taken_back = 0;
+
+        vector<long long> histogram;
+        long long total_questions = 0;
+        for (const Worker& worker : workers) {
+            if (worker.questions.size() > histogram.size()) {
+                histogram.resize(worker.questions.size(), 0);
+            }
+            for (size_t q = 0; q < worker.questions.size(); q++) {
+                histogram[q] += worker.questions[q];
+                total_questions += worker.questions[q] * static_cast<long long>(q);
+            }
+            report.guessed += worker.guessed;
+            report.learned += worker.learned;
+            report.restructured += worker.restructured;
+            report.surveyed += worker.surveyed;
+            report.taken_back += worker.taken_back;
+        }
+        report.avg_questions =
+            report.games ? static_cast<double>(total_questions) / report.games : 0.0;
+        report.p50_questions = percentile(histogram, report.games, 0.50);
+        report.p99_questions = percentile(histogram, report.games, 0.99);
+        report.max_questions = histogram.empty() ? 0 : static_cast<int>(histogram.size()) - 1;
+
+        size_t samples = workers.empty() ? 0 : workers[0].growth.size();
+        for (size_t s = 0; s < samples; s++) {
+            GrowthSample average = workers[0].growth[s];
+            average.nodes = 0;
+            average.avg_questions = 0;
+            for (const Worker& worker : workers) {
+                average.nodes += worker.growth[s].nodes;
+                average.max_depth = max(average.max_depth, worker.growth[s].max_depth);
+                average.avg_questions += worker.growth[s].avg_questions;
+            }
+            average.nodes /= opts.threads;
+            average.avg_questions /= opts.threads;
+            report.growth.push_back(average);
+        }
+        return report;
+    }
+
+    void print_report(const Report& report, ostream& output_stream) {
+        output_stream << fixed << setprecision(2);
+        output_stream << "games            " << report.games << endl;
+        output_stream << "seconds          " << report.seconds << endl;
+        output_stream << "games/sec        " << (report.seconds > 0 ? report.games / report.seconds : 0)
+                      << endl;
+        output_stream << "guessed right    " << report.guessed << endl;
+        output_stream << "learned          " << report.learned << endl;
+        output_stream << "avg questions    " << report.avg_questions << endl;
+        output_stream << "p50 questions    " << report.p50_questions << endl;
+        output_stream << "p99 questions    " << report.p99_questions << endl;
+        output_stream << "max questions    " << report.max_questions << endl;
+        if (report.restructured > 0 || report.surveyed > 0) {
+            output_stream << "restructured     " << report.restructured << endl;
+            output_stream << "answers surveyed " << report.surveyed << endl;
+            output_stream << "taken back       " << report.taken_back << endl;
+        }
+        output_stream << endl;
+        output_stream << "tree growth (per worker tree)" << endl;
+        output_stream << setw(12) << "games" << setw(12) << "nodes" << setw(12) << "max depth"
+                      << setw(16) << "avg questions" << endl;
+        for (const GrowthSample& sample : report.growth) {
+            output_stream << setw(12) << sample.games << setw(12) << sample.nodes << setw(12)
+                          << sample.max_depth << setw(16) << sample.avg_questions << endl;
+        }
+    }
+
+}  // namespace simulation
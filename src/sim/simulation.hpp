@@ -0,0 +1,109 @@
+/*
+ * Simulated Players
+ * file: simulation.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * purpose:
+ * load harness that plays many games with oracle players, players that know
+ * the ground truth traits of the animal they think of, to measure how fast the
+ * engine is and how good the tree gets
+ *
+ * changelog:
+ *  10/19/2026 - initial design, synthetic catalog, parallel runs
+ *  10/19/2026 - trees can be kept by a depth_watchdog
+ *  10/19/2026 - lessons taken back by the watchdogs are reported
+ *
+ * notes:
+ * - an AnimalTree has no locking of its own, so every worker thread grows its
+ *   own tree from the same starting point. Growth is reported per tree.
+ */
+
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "animal_tree.hpp"
+
+using namespace std;
+
+namespace simulation {
+
+    /*
+     * Ground truth of the simulation: every animal has a unique set of traits,
+     * trait j is asked either as "Does it have trait #j?" or "Does it lack trait #j?"
+     */
+    struct Catalog {
+        vector<string> animals;
+        int traits;
+        int words;               // 64 bit words per animal
+        vector<uint64_t> bits;   // animals x words, trait j of animal a is bit j
+        unordered_map<string, int> animal_index;
+        unordered_map<string, pair<int, bool>> question_index;  // trait, asks for presence
+
+        bool has(int animal, int trait) const;
+        static string question(int trait, bool presence);
+    };
+
+    // builds a catalog of random animals, animal 0 is the default "lizard"
+    Catalog random_catalog(int animals, int traits, uint64_t seed);
+
+    // player that answers for one target animal of the catalog
+    struct OraclePlayer : animal_tree::Player {
+        const Catalog& catalog;
+        int target;
+        mt19937_64& rng;
+
+        OraclePlayer(const Catalog& catalog, int target, mt19937_64& rng);
+
+        bool answer(const string& question);
+        bool confirm_guess(const string& animal);
+        bool teach(const string& guessed, string& animal, string& question);
+    };
+
+    struct Options {
+        long long games;   // games per worker
+        int threads;
+        int report_every;  // games between growth samples
+        uint64_t seed;
+        int max_depth;     // of the depth_watchdog of every tree, 0 for none
+    };
+
+    // snapshot of one tree while it grows
+    struct GrowthSample {
+        long long games;
+        long long nodes;
+        int max_depth;         // of the tree at the sample
+        double avg_questions;  // over the games since the previous sample
+    };
+
+    struct Report {
+        long long games;
+        double seconds;
+        double avg_questions;
+        int p50_questions;
+        int p99_questions;
+        int max_questions;
+        long long guessed;
+        long long learned;
+        long long restructured;  // subtrees rebuilt by the watchdogs
+        long long surveyed;      // answers the watchdogs collected
+        long long taken_back;    // lessons the watchdogs had no room for
+        vector<GrowthSample> growth;  // averaged over the worker trees
+    };
+
+    // plays opts.games games per worker thread, each worker on its own tree
+    Report run(const Catalog& catalog, const Options& opts);
+
+    void print_report(const Report& report, ostream& output_stream);
+
+}  // namespace simulation
+
+#endif  // SIMULATION_HPP
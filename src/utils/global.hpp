@@ -9,6 +9,8 @@
  * 10/29/2023 - changed to implement animal guessing homework
  * 10/30/2023
  *  - added debug flags
+ * 10/19/2026
+ *  - added persistence and registry debug flags
  */
 
 #include <iostream>
@@ -88,6 +90,10 @@ namespace global {
         const bool INSPECTING_NODE = false;
         const bool FLIPPING = false;
 
+        // persistence
+        const bool TREE_IO = false;
+        const bool REGISTRY = false;
+
     }  // namespace debug_flags
     // =----------------- END OF CONSTANTS -----------------=
     // ------------------------------------------------------
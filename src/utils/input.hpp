@@ -14,16 +14,20 @@
  *  10/22/2023 - integer bug fixed when non-integer input is given
  *  10/29/2023 - changed to implement animal guessing homework, removed 
  *  integer_within_threasold function
+ *  10/19/2026 - lines are read through transcript, the program exits when
+ *  the input ends instead of asking forever
  *
  * notes:
  */
 
+#include <cstdlib>
 #include <fstream>
 #include <string>
 #include <vector>
 
 #include "global.hpp"
 #include "output.hpp"
+#include "transcript.hpp"
 
 using namespace std;
 
@@ -41,13 +45,26 @@ namespace input {
 
     }  // namespace debug
 
+    /*
+     *   Reads the next line for the prompt msg, exits once the input (or the
+     *   replayed transcript) has ended.
+     */
+    inline string next_line(const string& msg) {
+        string input;
+        if (!transcript::read_line(msg, input)) {
+            output::separate();
+            output::inform("no more input");
+            exit(0);
+        }
+        return input;
+    }
+
     /*
      *   Used to retrieve a whole line of input from the user.
      */
     inline string line(const string& msg) {
-        string input;
         output::ask_for_input(msg + " : ");
-        getline(cin, input);
+        string input = next_line(msg);
 
         if (input.empty()) {
             output::error("input is empty");
@@ -60,17 +77,18 @@ namespace input {
     }
 
     inline int integer(const string& msg) {
-        int input;
         output::ask_for_input(msg);
-        while (!(cin >> input)) {
+        string text = next_line(msg);
+        char* end = nullptr;
+        long input = strtol(text.c_str(), &end, 10);
+        while (end == text.c_str()) {
             output::error("invalid input");
             output::ask_for_input(msg + " (must be an integer)");
-            cin.clear();  // Clear the error state.
-            cin.ignore(100, '\n');  // Discard non-integer input.
+            text = next_line(msg);
+            input = strtol(text.c_str(), &end, 10);
         }
-        cin.ignore(1, '\n');  // Discard the newline character.
         debug::user_input(to_string(input));
-        return input;
+        return static_cast<int>(input);
     }
 
     inline int integer_within_range(const string& msg, int min, int max) {
@@ -0,0 +1,243 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+/*
+ * Metrics
+ * file: metrics.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * latency histograms of the hot paths, shown through the "Show metrics" menu
+ * action and dumped in the Prometheus text format
+ *
+ * changelog:
+ *  10/19/2026 - initial log-linear histograms, turn/flip/load/save latencies
+ *  10/19/2026 - adaptive engine turn latency
+ *  10/19/2026 - page fault latency
+ *  10/19/2026 - replication lag
+ *
+ * notes:
+ * - values are nanoseconds. The first 32 buckets are exact, above that every
+ *   power of two is split into 16 linear buckets, so any recorded value is off
+ *   by less than 1/16 (~6%) and a histogram is a fixed 976 counters.
+ * - recording is a few relaxed atomic adds, safe from any thread.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+namespace metrics {
+
+    const int LINEAR_BUCKETS = 32;
+    const int SUB_BUCKET_BITS = 4;
+    const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    const int BUCKETS = LINEAR_BUCKETS + (64 - 5) * SUB_BUCKETS;
+
+    inline int bucket_of(uint64_t value) {
+        if (value < LINEAR_BUCKETS) {
+            return static_cast<int>(value);
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        int shift = exponent - SUB_BUCKET_BITS;
+        int mantissa = static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+        return LINEAR_BUCKETS + (exponent - 5) * SUB_BUCKETS + mantissa;
+    }
+
+    // largest value that falls in bucket
+    inline uint64_t bucket_upper(int bucket) {
+        if (bucket < LINEAR_BUCKETS) {
+            return bucket;
+        }
+        int exponent = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS + 5;
+        int mantissa = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+        int shift = exponent - SUB_BUCKET_BITS;
+        uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + mantissa) << shift;
+        return lower + ((1ULL << shift) - 1);
+    }
+
+    struct Histogram {
+        atomic<uint64_t> counts[BUCKETS];
+        atomic<uint64_t> total;
+        atomic<uint64_t> sum;
+        atomic<uint64_t> max;
+
+        Histogram() { reset(); }
+
+        void reset() {
+            for (int b = 0; b < BUCKETS; b++) {
+                counts[b].store(0, memory_order_relaxed);
+            }
+            total.store(0, memory_order_relaxed);
+            sum.store(0, memory_order_relaxed);
+            max.store(0, memory_order_relaxed);
+        }
+
+        void record(uint64_t value) {
+            counts[bucket_of(value)].fetch_add(1, memory_order_relaxed);
+            total.fetch_add(1, memory_order_relaxed);
+            sum.fetch_add(value, memory_order_relaxed);
+            uint64_t seen = max.load(memory_order_relaxed);
+            while (value > seen && !max.compare_exchange_weak(seen, value, memory_order_relaxed)) {
+            }
+        }
+
+        // upper bound of the bucket holding the p-th fraction of the values
+        uint64_t percentile(double p) const {
+            uint64_t n = total.load(memory_order_relaxed);
+            if (n == 0) {
+                return 0;
+            }
+            uint64_t rank = static_cast<uint64_t>(p * n);
+            uint64_t seen = 0;
+            for (int b = 0; b < BUCKETS; b++) {
+                seen += counts[b].load(memory_order_relaxed);
+                if (seen > rank) {
+                    uint64_t upper = bucket_upper(b);
+                    uint64_t largest = max.load(memory_order_relaxed);
+                    return upper < largest ? upper : largest;
+                }
+            }
+            return max.load(memory_order_relaxed);
+        }
+
+    private:
+        Histogram(const Histogram&);
+        Histogram& operator=(const Histogram&);
+    };
+
+    // -----------------------------------------------
+    // =--------------- RECORDED METRICS ------------=
+    enum Metric {
+        TURN_LATENCY,  // from an answer to the next prompt in play_game
+        FLIP_LATENCY,  // flip_to_question
+        LOAD_LATENCY,  // tree_io::load_file
+        SAVE_LATENCY,  // tree_io::save_file
+        ADAPTIVE_TURN_LATENCY,  // choosing a question in the adaptive engine
+        PAGE_FAULT_LATENCY,     // loading a page of a paged tree
+        REPLICATION_LAG,        // from a flip on the leader to the same flip on a follower
+        METRIC_COUNT
+    };
+
+    inline const char* name_of(Metric metric) {
+        static const char* names[METRIC_COUNT] = {
+            "animal_turn_latency_seconds",
+            "animal_flip_latency_seconds",
+            "animal_tree_load_seconds",
+            "animal_tree_save_seconds",
+            "animal_adaptive_turn_latency_seconds",
+            "animal_page_fault_seconds",
+            "animal_replication_lag_seconds",
+        };
+        return names[metric];
+    }
+
+    inline const char* help_of(Metric metric) {
+        static const char* helps[METRIC_COUNT] = {
+            "Time from an answer to the next prompt in play_game.",
+            "Time spent in flip_to_question.",
+            "Time spent loading a tree from disk.",
+            "Time spent saving a tree to disk.",
+            "Time the adaptive engine takes to choose the next question.",
+            "Time spent loading a page of a paged tree.",
+            "Time from a flip on the leader to the same flip on a follower.",
+        };
+        return helps[metric];
+    }
+
+    inline Histogram& histogram(Metric metric) {
+        static Histogram all[METRIC_COUNT];
+        return all[metric];
+    }
+
+    inline uint64_t now_ns() {
+        return chrono::duration_cast<chrono::nanoseconds>(
+                   chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    inline void record(Metric metric, uint64_t nanoseconds) {
+        histogram(metric).record(nanoseconds);
+    }
+
+    /*
+     *  records the lifetime of the timer into metric
+     */
+    struct Timer {
+        Metric metric;
+        uint64_t start;
+
+        explicit Timer(Metric metric) : metric(metric), start(now_ns()) {}
+        ~Timer() { record(metric, now_ns() - start); }
+    };
+
+    // =------------- END OF RECORDED METRICS -------------=
+    // -----------------------------------------------------
+
+    /*
+     *  human readable table, latencies in microseconds
+     */
+    inline void print(ostream& output_stream) {
+        ios::fmtflags flags = output_stream.flags();
+        streamsize precision = output_stream.precision();
+        output_stream << left << setw(40) << "metric" << right << setw(10) << "count"
+                      << setw(12) << "p50 us" << setw(12) << "p99 us" << setw(12) << "p999 us"
+                      << setw(12) << "max us" << endl;
+        output_stream << fixed << setprecision(1);
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            const Histogram& h = histogram(static_cast<Metric>(m));
+            output_stream << left << setw(40) << name_of(static_cast<Metric>(m)) << right
+                          << setw(10) << h.total.load() << setw(12) << h.percentile(0.50) / 1e3
+                          << setw(12) << h.percentile(0.99) / 1e3 << setw(12)
+                          << h.percentile(0.999) / 1e3 << setw(12) << h.max.load() / 1e3 << endl;
+        }
+        output_stream.flags(flags);
+        output_stream.precision(precision);
+    }
+
+    /*
+     *  Prometheus text exposition format. Only non empty buckets are listed,
+     *  the quantiles are exported as a separate gauge per metric.
+     */
+    inline void dump_prometheus(ostream& output_stream) {
+        streamsize precision = output_stream.precision(9);
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            Metric metric = static_cast<Metric>(m);
+            const Histogram& h = histogram(metric);
+            string name = name_of(metric);
+
+            output_stream << "# HELP " << name << " " << help_of(metric) << "\n";
+            output_stream << "# TYPE " << name << " histogram\n";
+            uint64_t cumulative = 0;
+            for (int b = 0; b < BUCKETS; b++) {
+                uint64_t count = h.counts[b].load(memory_order_relaxed);
+                if (count == 0) {
+                    continue;
+                }
+                cumulative += count;
+                output_stream << name << "_bucket{le=\"" << bucket_upper(b) / 1e9 << "\"} "
+                              << cumulative << "\n";
+            }
+            output_stream << name << "_bucket{le=\"+Inf\"} " << h.total.load() << "\n";
+            output_stream << name << "_sum " << h.sum.load() / 1e9 << "\n";
+            output_stream << name << "_count " << h.total.load() << "\n";
+
+            string quantile_name = name + "_quantile";
+            output_stream << "# TYPE " << quantile_name << " gauge\n";
+            const double quantiles[] = {0.5, 0.99, 0.999};
+            for (double q : quantiles) {
+                output_stream << quantile_name << "{quantile=\"" << q << "\"} "
+                              << h.percentile(q) / 1e9 << "\n";
+            }
+        }
+        output_stream.precision(precision);
+    }
+
+}  // namespace metrics
+
+#endif  // METRICS_HPP
@@ -0,0 +1,368 @@
+#ifndef TRANSCRIPT_HPP
+#define TRANSCRIPT_HPP
+/*
+ * Transcript
+ * file: transcript.hpp
+ * author: Diego R.R.
+ * started: 10/19/2026
+ * course: CS2337.501
+ *
+ * records the answers of an interactive session and replays them, so a real
+ * session can be re-run against another build as a performance regression
+ * test (app --record FILE / app --replay FILE [--paced])
+ *
+ * changelog:
+ *  10/19/2026 - initial recording and replay
+ *
+ * notes:
+ * - every line read by input is a step, written as one line of the file:
+ *     <wait us> TAB <response us> TAB <output hash> TAB <prompt> TAB <answer>
+ *   wait is how long the user took to answer, response how long the program
+ *   took from the previous answer to this prompt, and the hash is an FNV-1a
+ *   of everything written to cout in between. Tabs and backslashes in the
+ *   prompt and answer are escaped.
+ * - a replay feeds the recorded answers back without waiting (or waiting the
+ *   recorded time with --paced), hashes the output instead of showing it and
+ *   prints how the outputs and response times compare when the program ends
+ *   or runs out of answers.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.hpp"
+
+using namespace std;
+
+namespace transcript {
+
+    const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    const uint64_t FNV_PRIME = 1099511628211ULL;
+    const size_t REPORTED_STEPS = 5;  // differences and slowdowns listed by the report
+
+    struct Step {
+        uint64_t wait_us;
+        uint64_t response_us;
+        uint64_t output_hash;
+        string prompt;
+        string answer;
+    };
+
+    /*
+     *  hashes what is written through it, passing it on to forward unless
+     *  forward is null
+     */
+    struct HashingBuffer : streambuf {
+        streambuf* forward;
+        uint64_t hash;
+
+        explicit HashingBuffer(streambuf* forward) : forward(forward), hash(FNV_OFFSET) {}
+
+    protected:
+        int overflow(int c) {
+            if (c != traits_type::eof()) {
+                hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+                if (forward) {
+                    return forward->sputc(static_cast<char>(c));
+                }
+            }
+            return c;
+        }
+
+        streamsize xsputn(const char* text, streamsize count) {
+            for (streamsize i = 0; i < count; i++) {
+                hash = (hash ^ static_cast<unsigned char>(text[i])) * FNV_PRIME;
+            }
+            return forward ? forward->sputn(text, count) : count;
+        }
+
+        int sync() { return forward ? forward->pubsync() : 0; }
+    };
+
+    enum Mode { OFF, RECORDING, REPLAYING };
+
+    struct State {
+        Mode mode;
+        bool paced;
+        ofstream file;           // recording
+        vector<Step> recorded;   // replaying
+        vector<Step> replayed;
+        HashingBuffer* buffer;
+        streambuf* original;     // cout's own buffer
+        uint64_t answered_at;    // when the previous answer was read
+        uint64_t started_at;
+
+        State() : mode(OFF), paced(false), buffer(nullptr), original(nullptr), answered_at(0),
+                  started_at(0) {}
+    };
+
+    inline State& state() {
+        static State session;
+        return session;
+    }
+
+    inline string escape(const string& text) {
+        string escaped;
+        for (char c : text) {
+            if (c == '\\') {
+                escaped += "\\\\";
+            } else if (c == '\t') {
+                escaped += "\\t";
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    inline string unescape(const string& text) {
+        string plain;
+        for (size_t i = 0; i < text.size(); i++) {
+            if (text[i] == '\\' && i + 1 < text.size()) {
+                i++;
+                plain += text[i] == 't' ? '\t' : text[i];
+            } else {
+                plain += text[i];
+            }
+        }
+        return plain;
+    }
+
+    inline void write_step(ostream& output_stream, const Step& step) {
+        output_stream << step.wait_us << '\t' << step.response_us << '\t' << hex
+                      << step.output_hash << dec << '\t' << escape(step.prompt) << '\t'
+                      << escape(step.answer) << '\n';
+    }
+
+    // false if line isn't a step
+    inline bool parse_step(const string& line, Step& step) {
+        vector<string> fields;
+        size_t start = 0;
+        for (int i = 0; i < 4; i++) {
+            size_t tab = line.find('\t', start);
+            if (tab == string::npos) {
+                return false;
+            }
+            fields.push_back(line.substr(start, tab - start));
+            start = tab + 1;
+        }
+        char* end = nullptr;
+        step.wait_us = strtoull(fields[0].c_str(), &end, 10);
+        step.response_us = strtoull(fields[1].c_str(), &end, 10);
+        step.output_hash = strtoull(fields[2].c_str(), &end, 16);
+        step.prompt = unescape(fields[3]);
+        step.answer = unescape(line.substr(start));
+        return true;
+    }
+
+    // routes cout through the hashing buffer, shown only if show is set
+    inline void hook_output(bool show) {
+        State& session = state();
+        session.original = cout.rdbuf();
+        session.buffer = new HashingBuffer(show ? session.original : nullptr);
+        cout.rdbuf(session.buffer);
+        session.started_at = metrics::now_ns();
+        session.answered_at = session.started_at;
+    }
+
+    // closes the step that ends with the answer just read
+    inline Step end_step(const string& prompt, const string& answer, uint64_t prompted_at) {
+        State& session = state();
+        uint64_t now = metrics::now_ns();
+        Step step;
+        step.response_us = (prompted_at - session.answered_at) / 1000;
+        step.wait_us = (now - prompted_at) / 1000;
+        step.output_hash = session.buffer->hash;
+        step.prompt = prompt;
+        step.answer = answer;
+        session.buffer->hash = FNV_OFFSET;
+        session.answered_at = now;
+        return step;
+    }
+
+    inline uint64_t percentile(vector<uint64_t> values, double p) {
+        if (values.empty()) {
+            return 0;
+        }
+        sort(values.begin(), values.end());
+        return values[min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+    }
+
+    /*
+     *  compares the replayed steps to the recorded ones
+     */
+    inline void print_report(ostream& output_stream) {
+        State& session = state();
+        const vector<Step>& recorded = session.recorded;
+        const vector<Step>& replayed = session.replayed;
+        size_t steps = min(recorded.size(), replayed.size());
+
+        uint64_t recorded_us = 0;
+        vector<uint64_t> recorded_response;
+        vector<uint64_t> replayed_response;
+        vector<size_t> different;
+        vector<pair<long long, size_t> > slowdowns;
+        for (size_t i = 0; i < recorded.size(); i++) {
+            recorded_us += recorded[i].wait_us + recorded[i].response_us;
+        }
+        for (size_t i = 0; i < steps; i++) {
+            recorded_response.push_back(recorded[i].response_us);
+            replayed_response.push_back(replayed[i].response_us);
+            if (recorded[i].output_hash != replayed[i].output_hash ||
+                recorded[i].prompt != replayed[i].prompt) {
+                different.push_back(i);
+            }
+            long long slower = static_cast<long long>(replayed[i].response_us) -
+                               static_cast<long long>(recorded[i].response_us);
+            slowdowns.push_back(make_pair(slower, i));
+        }
+        sort(slowdowns.rbegin(), slowdowns.rend());
+
+        ios::fmtflags flags = output_stream.flags();
+        streamsize precision = output_stream.precision();
+        output_stream << fixed << setprecision(3);
+        output_stream << "replayed " << replayed.size() << " of " << recorded.size()
+                      << " steps in " << (metrics::now_ns() - session.started_at) / 1e9
+                      << " s, the recorded session took " << recorded_us / 1e6 << " s\n";
+        output_stream << left << setw(12) << "response" << right << setw(14) << "recorded us"
+                      << setw(14) << "replayed us\n";
+        const double quantiles[] = {0.5, 0.99, 1.0};
+        const char* names[] = {"p50", "p99", "max"};
+        for (int q = 0; q < 3; q++) {
+            output_stream << left << setw(12) << names[q] << right << setw(14)
+                          << percentile(recorded_response, quantiles[q]) << setw(14)
+                          << percentile(replayed_response, quantiles[q]) << '\n';
+        }
+        output_stream << "steps slower than recorded:\n";
+        for (size_t i = 0; i < slowdowns.size() && i < REPORTED_STEPS && slowdowns[i].first > 0;
+             i++) {
+            const Step& step = recorded[slowdowns[i].second];
+            output_stream << "  step " << slowdowns[i].second + 1 << " \"" << step.prompt
+                          << "\": " << step.response_us << " -> "
+                          << replayed[slowdowns[i].second].response_us << " us\n";
+        }
+        if (different.empty() && replayed.size() == recorded.size()) {
+            output_stream << "output matches the recording\n";
+        } else {
+            output_stream << "output differs at " << different.size() << " steps\n";
+            for (size_t i = 0; i < different.size() && i < REPORTED_STEPS; i++) {
+                const Step& before = recorded[different[i]];
+                const Step& now = replayed[different[i]];
+                output_stream << "  step " << different[i] + 1 << " \"" << before.prompt << "\"";
+                if (before.prompt != now.prompt) {
+                    output_stream << " is now \"" << now.prompt << "\"";
+                } else {
+                    output_stream << ": the output before it changed";
+                }
+                output_stream << '\n';
+            }
+        }
+        output_stream.flags(flags);
+        output_stream.precision(precision);
+    }
+
+    // restores cout and reports the replay, runs at exit
+    inline void finish() {
+        State& session = state();
+        if (session.mode == OFF) {
+            return;
+        }
+        cout.flush();
+        cout.rdbuf(session.original);
+        if (session.mode == REPLAYING) {
+            print_report(cout);
+        } else {
+            session.file.close();
+        }
+        delete session.buffer;
+        session.buffer = nullptr;
+        session.mode = OFF;
+    }
+
+    /*
+     *  starts writing every answer read by input to path
+     */
+    inline bool start_recording(const string& path) {
+        State& session = state();
+        session.file.open(path.c_str());
+        if (!session.file) {
+            return false;
+        }
+        session.file << "# animal transcript: wait us, response us, output hash, prompt, answer\n";
+        session.mode = RECORDING;
+        hook_output(true);
+        atexit(finish);
+        return true;
+    }
+
+    /*
+     *  input reads the answers recorded at path from now on, paced waits the
+     *  time the user took to answer each one
+     */
+    inline bool start_replay(const string& path, bool paced) {
+        State& session = state();
+        ifstream input_file(path.c_str());
+        if (!input_file) {
+            return false;
+        }
+        string line;
+        Step step;
+        while (getline(input_file, line)) {
+            if (!line.empty() && line[0] != '#' && parse_step(line, step)) {
+                session.recorded.push_back(step);
+            }
+        }
+        session.mode = REPLAYING;
+        session.paced = paced;
+        hook_output(false);
+        atexit(finish);
+        return true;
+    }
+
+    inline bool replaying() {
+        return state().mode == REPLAYING;
+    }
+
+    /*
+     *  reads the answer to prompt, from cin or from the replayed transcript
+     *  returns false once there is nothing left to read
+     */
+    inline bool read_line(const string& prompt, string& line) {
+        State& session = state();
+        if (session.mode == OFF) {
+            return static_cast<bool>(getline(cin, line));
+        }
+        uint64_t prompted_at = metrics::now_ns();
+        if (session.mode == RECORDING) {
+            cout.flush();
+            if (!getline(cin, line)) {
+                return false;
+            }
+            write_step(session.file, end_step(prompt, line, prompted_at));
+            session.file.flush();
+            return true;
+        }
+
+        size_t next = session.replayed.size();
+        if (next >= session.recorded.size()) {
+            return false;
+        }
+        line = session.recorded[next].answer;
+        if (session.paced) {
+            this_thread::sleep_for(chrono::microseconds(session.recorded[next].wait_us));
+        }
+        session.replayed.push_back(end_step(prompt, line, prompted_at));
+        return true;
+    }
+
+}  // namespace transcript
+
+#endif  // TRANSCRIPT_HPP